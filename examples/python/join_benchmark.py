@@ -0,0 +1,54 @@
+import asyncio
+import sys
+import time
+
+from ntgcalls import NTgCalls, MediaDescription, AudioDescription, InputMode, FactoryConfig
+
+calls = int(sys.argv[1]) if len(sys.argv) > 1 else 50
+
+
+async def run(certificate_rotation: int):
+    config = FactoryConfig()
+    config.certificateRotation = certificate_rotation
+    NTgCalls.set_factory_config(config)
+    wrtc = NTgCalls()
+    media = MediaDescription(
+        audio=AudioDescription(
+            input_mode=InputMode.Shell,
+            input="cat /dev/zero",
+            sample_rate=48000,
+            bits_per_sample=16,
+            channel_count=2,
+        ),
+    )
+    # Warms up the factory, so only the offers are measured
+    await wrtc.create_call_async(0, media)
+
+    latencies = []
+
+    async def join(chat_id: int):
+        start = time.perf_counter()
+        await wrtc.create_call_async(chat_id, media)
+        latencies.append(time.perf_counter() - start)
+
+    cpu_start, wall_start = time.process_time(), time.perf_counter()
+    await asyncio.gather(*[join(chat_id) for chat_id in range(1, calls + 1)])
+    cpu, wall = time.process_time() - cpu_start, time.perf_counter() - wall_start
+
+    for chat_id in range(calls + 1):
+        wrtc.stop(chat_id)
+    latencies.sort()
+    print(
+        f"certificate cache {'on ' if certificate_rotation else 'off'}: "
+        f"{calls} joins in {wall * 1000:.0f} ms, cpu {cpu * 1000:.0f} ms, "
+        f"median {latencies[len(latencies) // 2] * 1000:.1f} ms, "
+        f"p95 {latencies[int(len(latencies) * 0.95)] * 1000:.1f} ms"
+    )
+
+
+async def main():
+    await run(0)
+    await run(3600)
+
+
+asyncio.new_event_loop().run_until_complete(main())
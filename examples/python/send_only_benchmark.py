@@ -0,0 +1,59 @@
+import asyncio
+import time
+
+from ntgcalls import NTgCalls, MediaDescription, AudioDescription, VideoDescription, InputMode, FactoryConfig
+from pyrogram import Client
+
+from utils import connect_call
+
+api_id = 2799555
+api_hash = '47d66bbf0939d0ddf32caf8bad590ed7'
+chat_id = -1001919448795
+seconds = 30
+
+
+async def run(client: Client, send_only: bool) -> float:
+    config = FactoryConfig()
+    config.sendOnly = send_only
+    NTgCalls.set_factory_config(config)
+    wrtc = NTgCalls()
+    call_params = await wrtc.create_call_async(chat_id, MediaDescription(
+        audio=AudioDescription(
+            input_mode=InputMode.Shell,
+            input="ffmpeg -f lavfi -i sine=frequency=440 -f s16le -ac 2 -ar 48k pipe:1",
+            sample_rate=48000,
+            bits_per_sample=16,
+            channel_count=2,
+        ),
+        video=VideoDescription(
+            input_mode=InputMode.Shell,
+            input="ffmpeg -f lavfi -i testsrc=size=1280x720:rate=30 -f rawvideo -pix_fmt yuv420p pipe:1",
+            width=1280,
+            height=720,
+            fps=30,
+        ),
+    ))
+    result = await connect_call(client, chat_id, call_params)
+    await wrtc.connect_async(chat_id, result)
+    # Encoders settle after the first keyframes and the bandwidth ramp up
+    await asyncio.sleep(5)
+    start = time.process_time()
+    await asyncio.sleep(seconds)
+    cpu = time.process_time() - start
+    wrtc.stop(chat_id)
+    # Leaves time to the server to drop the previous participant
+    await asyncio.sleep(5)
+    return cpu / seconds * 100
+
+
+async def main():
+    client = Client('test', api_id, api_hash, sleep_threshold=1)
+    async with client:
+        send_receive = await run(client, False)
+        send_only = await run(client, True)
+    print(f"send and receive: {send_receive:.1f}% cpu")
+    print(f"send only:        {send_only:.1f}% cpu")
+    print(f"saved per call:   {send_receive - send_only:.1f}% cpu")
+
+
+asyncio.new_event_loop().run_until_complete(main())
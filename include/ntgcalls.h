@@ -19,6 +19,7 @@
 // NTgCalls
 #define NTG_CONNECTION_ALREADY_EXISTS (-100)
 #define NTG_CONNECTION_NOT_FOUND (-101)
+#define NTG_FACTORY_IN_USE (-102)
 
 // STREAM
 #define NTG_FILE_NOT_FOUND (-200)
@@ -35,6 +36,7 @@
 #define NTG_UNKNOWN_EXCEPTION (-1)
 #define NTG_INVALID_UID (-2)
 #define NTG_ERR_TOO_SMALL (-3)
+#define NTG_NULL_POINTER (-4)
 
 #ifdef __cplusplus
 extern "C" {
@@ -49,6 +51,52 @@ typedef enum {
     NTG_FFMPEG
 } ntg_input_mode_enum;
 
+typedef enum {
+    NTG_AUDIO_PROFILE_VOICE,
+    NTG_AUDIO_PROFILE_MUSIC
+} ntg_audio_profile_enum;
+
+typedef enum {
+    NTG_ICE_PROFILE_STANDARD,
+    NTG_ICE_PROFILE_RESTRICTED
+} ntg_ice_profile_enum;
+
+typedef enum {
+    NTG_PIXEL_FORMAT_I420,
+    NTG_PIXEL_FORMAT_NV12,
+    NTG_PIXEL_FORMAT_RGB24,
+    NTG_PIXEL_FORMAT_RGBA,
+    NTG_PIXEL_FORMAT_BGRA,
+    NTG_PIXEL_FORMAT_YUYV,
+    NTG_PIXEL_FORMAT_UYVY
+} ntg_pixel_format_enum;
+
+typedef enum {
+    NTG_VIDEO_CODEC_VP8,
+    NTG_VIDEO_CODEC_VP9,
+    NTG_VIDEO_CODEC_AV1
+} ntg_video_codec_enum;
+
+typedef enum {
+    NTG_ENCODER_PRESET_DEFAULT,
+    NTG_ENCODER_PRESET_QUALITY
+} ntg_encoder_preset_enum;
+
+typedef enum {
+    NTG_CONTENT_HINT_GENERIC,
+    NTG_CONTENT_HINT_MOTION,
+    NTG_CONTENT_HINT_DETAIL,
+    NTG_CONTENT_HINT_TEXT
+} ntg_content_hint_enum;
+
+typedef enum {
+    NTG_DEGRADATION_AUTO,
+    NTG_DEGRADATION_BALANCED,
+    NTG_DEGRADATION_MAINTAIN_FRAMERATE,
+    NTG_DEGRADATION_MAINTAIN_RESOLUTION,
+    NTG_DEGRADATION_DISABLED
+} ntg_degradation_preference_enum;
+
 typedef enum {
     NTG_STREAM_AUDIO,
     NTG_STREAM_VIDEO
@@ -60,11 +108,32 @@ typedef enum {
     NTG_IDLING
 } ntg_stream_status_enum;
 
+typedef struct {
+    uint32_t bitrate;
+    int8_t complexity;
+    bool stereo, fec;
+    uint8_t packetTime;
+    uint32_t minBitrate, maxBitrate;
+} ntg_audio_encoding_struct;
+
+typedef struct {
+    uint8_t threads;
+    ntg_encoder_preset_enum preset;
+    ntg_content_hint_enum contentHint;
+    ntg_degradation_preference_enum degradation;
+    uint8_t simulcastLayers, temporalLayers;
+    uint32_t startBitrate, minBitrate, maxBitrate;
+} ntg_video_encoding_struct;
+
 typedef struct {
     ntg_input_mode_enum inputMode;
     char* input;
     uint32_t sampleRate;
     uint8_t bitsPerSample, channelCount;
+    uint16_t silenceWindow;
+    ntg_audio_encoding_struct* encoding;
+    bool planar;
+    uint8_t downmixChannels;
 } ntg_audio_description_struct;
 
 typedef struct {
@@ -72,6 +141,15 @@ typedef struct {
     char* input;
     uint16_t width, height;
     uint8_t fps;
+    ntg_pixel_format_enum pixelFormat;
+    bool adaptiveScaling;
+    uint16_t staticRefresh;
+    uint16_t syncTolerance;
+    uint16_t keyframeInterval;
+    bool timestamped;
+    ntg_video_encoding_struct* encoding;
+    ntg_video_codec_enum* codecs;
+    uint8_t codecsCount;
 } ntg_video_description_struct;
 
 typedef struct {
@@ -79,6 +157,19 @@ typedef struct {
     ntg_video_description_struct* video;
 } ntg_media_description_struct;
 
+typedef struct {
+    ntg_audio_profile_enum audioProfile;
+    uint32_t connectTimeout;
+    uint8_t poolSize;
+    uint32_t certificateRotation;
+    ntg_ice_profile_enum iceProfile;
+    uint16_t minPort;
+    uint16_t maxPort;
+    bool disableIpv6;
+    uint32_t uplinkBudget;
+    bool sendOnly;
+} ntg_factory_config_struct;
+
 typedef struct {
     int64_t chatId;
     ntg_stream_status_enum status;
@@ -90,24 +181,51 @@ typedef struct {
     bool videoStopped;
 } ntg_media_state_struct;
 
+typedef struct {
+    double silenceRatio;
+    uint64_t skippedFrames;
+    double avOffset;
+} ntg_stream_stats_struct;
+
+typedef struct {
+    uint32_t size;
+    uint32_t ready;
+    uint64_t hits;
+    uint64_t misses;
+} ntg_warm_pool_stats_struct;
+
 typedef void (*ntg_stream_callback)(uint32_t, int64_t, ntg_stream_type_enum);
 
 typedef void (*ntg_upgrade_callback)(uint32_t, int64_t, ntg_media_state_struct);
 
+// Params are only valid during the call, rejoin with them and pass the result to ntg_connect
+typedef void (*ntg_reconnect_callback)(uint32_t, int64_t, const char*);
+
+// Result is 0 or one of the error codes, params is only valid during the call and NULL on failure
+typedef void (*ntg_params_callback)(uint32_t, int64_t, int, const char*);
+
+typedef void (*ntg_connect_callback)(uint32_t, int64_t, int);
+
 NTG_C_EXPORT uint32_t ntg_init();
 
 NTG_C_EXPORT int ntg_destroy(uint32_t uid);
 
 NTG_C_EXPORT int ntg_get_params(uint32_t uid, int64_t chatID, ntg_media_description_struct desc, char* buffer, int size);
 
+NTG_C_EXPORT int ntg_get_params_async(uint32_t uid, int64_t chatID, ntg_media_description_struct desc, ntg_params_callback callback);
+
 NTG_C_EXPORT int ntg_connect(uint32_t uid, int64_t chatID, char* params);
 
+NTG_C_EXPORT int ntg_connect_async(uint32_t uid, int64_t chatID, char* params, ntg_connect_callback callback);
+
 NTG_C_EXPORT int ntg_change_stream(uint32_t uid, int64_t chatID, ntg_media_description_struct desc);
 
 NTG_C_EXPORT int ntg_pause(uint32_t uid, int64_t chatID);
 
 NTG_C_EXPORT int ntg_resume(uint32_t uid, int64_t chatID);
 
+NTG_C_EXPORT int ntg_request_keyframe(uint32_t uid, int64_t chatID);
+
 NTG_C_EXPORT int ntg_mute(uint32_t uid, int64_t chatID);
 
 NTG_C_EXPORT int ntg_unmute(uint32_t uid, int64_t chatID);
@@ -118,6 +236,8 @@ NTG_C_EXPORT int64_t ntg_time(uint32_t uid, int64_t chatID);
 
 NTG_C_EXPORT int ntg_get_state(uint32_t uid, int64_t chatID, ntg_media_state_struct *mediaState);
 
+NTG_C_EXPORT int ntg_get_stats(uint32_t uid, int64_t chatID, ntg_stream_stats_struct *streamStats);
+
 NTG_C_EXPORT int ntg_calls(uint32_t uid, ntg_group_call_struct *buffer, int size);
 
 NTG_C_EXPORT int ntg_calls_count(uint32_t uid);
@@ -126,8 +246,16 @@ NTG_C_EXPORT int ntg_on_stream_end(uint32_t uid, ntg_stream_callback callback);
 
 NTG_C_EXPORT int ntg_on_upgrade(uint32_t uid, ntg_upgrade_callback callback);
 
+NTG_C_EXPORT int ntg_on_reconnect(uint32_t uid, ntg_reconnect_callback callback);
+
 NTG_C_EXPORT int ntg_get_version(char* buffer, int size);
 
+NTG_C_EXPORT int ntg_set_factory_config(ntg_factory_config_struct config);
+
+NTG_C_EXPORT int ntg_set_warm_pool_size(uint32_t uid, uint32_t size);
+
+NTG_C_EXPORT int ntg_get_warm_pool_stats(uint32_t uid, ntg_warm_pool_stats_struct *stats);
+
 #ifdef __cplusplus
 }
 #endif
@@ -7,8 +7,8 @@
 
 #include "ntgcalls/exceptions.hpp"
 
-std::map<uint32_t, std::shared_ptr<ntgcalls::NTgCalls>> clients;
-uint32_t uidGenerator;
+ntgcalls::ConcurrentMap<uint32_t, ntgcalls::NTgCalls> clients;
+std::atomic<uint32_t> uidGenerator;
 
 int copyAndReturn(std::string s, char *buffer, const int size) {
     if (!buffer)
@@ -38,10 +38,11 @@ template <typename T> int copyAndReturn(std::vector<T> b, T *buffer, const int s
 }
 
 std::shared_ptr<ntgcalls::NTgCalls> safeUID(const uint32_t uid) {
-    if (!clients.contains(uid)) {
+    auto instance = clients.find(uid);
+    if (!instance) {
         throw ntgcalls::InvalidUUID("UUID" + std::to_string(uid) + " not found");
     }
-    return clients[uid];
+    return instance;
 }
 
 ntgcalls::BaseMediaDescription::InputMode parseInputMode(const ntg_input_mode_enum mode) {
@@ -56,6 +57,124 @@ ntgcalls::BaseMediaDescription::InputMode parseInputMode(const ntg_input_mode_en
     return {};
 }
 
+wrtc::AudioProfile parseAudioProfile(const ntg_audio_profile_enum profile) {
+    switch (profile) {
+        case NTG_AUDIO_PROFILE_VOICE:
+            return wrtc::AudioProfile::Voice;
+        case NTG_AUDIO_PROFILE_MUSIC:
+            return wrtc::AudioProfile::Music;
+    }
+    return {};
+}
+
+wrtc::IceProfile parseIceProfile(const ntg_ice_profile_enum profile) {
+    switch (profile) {
+        case NTG_ICE_PROFILE_STANDARD:
+            return wrtc::IceProfile::Standard;
+        case NTG_ICE_PROFILE_RESTRICTED:
+            return wrtc::IceProfile::Restricted;
+    }
+    return {};
+}
+
+ntgcalls::AudioEncoding parseAudioEncoding(const ntg_audio_encoding_struct& encoding) {
+    ntgcalls::AudioEncoding res;
+    res.bitrate = encoding.bitrate;
+    res.complexity = encoding.complexity;
+    res.stereo = encoding.stereo;
+    res.fec = encoding.fec;
+    res.packetTime = encoding.packetTime;
+    res.minBitrate = encoding.minBitrate;
+    res.maxBitrate = encoding.maxBitrate;
+    return res;
+}
+
+wrtc::PixelFormat parsePixelFormat(const ntg_pixel_format_enum format) {
+    switch (format) {
+        case NTG_PIXEL_FORMAT_I420:
+            return wrtc::PixelFormat::I420;
+        case NTG_PIXEL_FORMAT_NV12:
+            return wrtc::PixelFormat::NV12;
+        case NTG_PIXEL_FORMAT_RGB24:
+            return wrtc::PixelFormat::RGB24;
+        case NTG_PIXEL_FORMAT_RGBA:
+            return wrtc::PixelFormat::RGBA;
+        case NTG_PIXEL_FORMAT_BGRA:
+            return wrtc::PixelFormat::BGRA;
+        case NTG_PIXEL_FORMAT_YUYV:
+            return wrtc::PixelFormat::YUYV;
+        case NTG_PIXEL_FORMAT_UYVY:
+            return wrtc::PixelFormat::UYVY;
+    }
+    return {};
+}
+
+wrtc::VideoCodec parseVideoCodec(const ntg_video_codec_enum codec) {
+    switch (codec) {
+        case NTG_VIDEO_CODEC_VP8:
+            return wrtc::VideoCodec::VP8;
+        case NTG_VIDEO_CODEC_VP9:
+            return wrtc::VideoCodec::VP9;
+        case NTG_VIDEO_CODEC_AV1:
+            return wrtc::VideoCodec::AV1;
+    }
+    return {};
+}
+
+wrtc::EncoderPreset parseEncoderPreset(const ntg_encoder_preset_enum preset) {
+    switch (preset) {
+        case NTG_ENCODER_PRESET_DEFAULT:
+            return wrtc::EncoderPreset::Default;
+        case NTG_ENCODER_PRESET_QUALITY:
+            return wrtc::EncoderPreset::Quality;
+    }
+    return {};
+}
+
+wrtc::ContentHint parseContentHint(const ntg_content_hint_enum hint) {
+    switch (hint) {
+        case NTG_CONTENT_HINT_GENERIC:
+            return wrtc::ContentHint::Generic;
+        case NTG_CONTENT_HINT_MOTION:
+            return wrtc::ContentHint::Motion;
+        case NTG_CONTENT_HINT_DETAIL:
+            return wrtc::ContentHint::Detail;
+        case NTG_CONTENT_HINT_TEXT:
+            return wrtc::ContentHint::Text;
+    }
+    return {};
+}
+
+wrtc::DegradationPreference parseDegradationPreference(const ntg_degradation_preference_enum preference) {
+    switch (preference) {
+        case NTG_DEGRADATION_AUTO:
+            return wrtc::DegradationPreference::Auto;
+        case NTG_DEGRADATION_BALANCED:
+            return wrtc::DegradationPreference::Balanced;
+        case NTG_DEGRADATION_MAINTAIN_FRAMERATE:
+            return wrtc::DegradationPreference::MaintainFramerate;
+        case NTG_DEGRADATION_MAINTAIN_RESOLUTION:
+            return wrtc::DegradationPreference::MaintainResolution;
+        case NTG_DEGRADATION_DISABLED:
+            return wrtc::DegradationPreference::Disabled;
+    }
+    return {};
+}
+
+ntgcalls::VideoEncoding parseVideoEncoding(const ntg_video_encoding_struct& encoding) {
+    ntgcalls::VideoEncoding res;
+    res.threads = encoding.threads;
+    res.preset = parseEncoderPreset(encoding.preset);
+    res.contentHint = parseContentHint(encoding.contentHint);
+    res.degradation = parseDegradationPreference(encoding.degradation);
+    res.simulcastLayers = encoding.simulcastLayers;
+    res.temporalLayers = encoding.temporalLayers;
+    res.startBitrate = encoding.startBitrate;
+    res.minBitrate = encoding.minBitrate;
+    res.maxBitrate = encoding.maxBitrate;
+    return res;
+}
+
 ntg_media_state_struct parseMediaState(const ntgcalls::MediaState state) {
     return ntg_media_state_struct{
             state.muted,
@@ -64,6 +183,23 @@ ntg_media_state_struct parseMediaState(const ntgcalls::MediaState state) {
     };
 }
 
+ntg_stream_stats_struct parseStreamStats(const ntgcalls::StreamStats stats) {
+    return ntg_stream_stats_struct{
+            stats.silenceRatio,
+            stats.skippedFrames,
+            stats.avOffset,
+    };
+}
+
+ntg_warm_pool_stats_struct parseWarmPoolStats(const ntgcalls::WarmPoolStats stats) {
+    return ntg_warm_pool_stats_struct{
+            stats.size,
+            stats.ready,
+            stats.hits,
+            stats.misses,
+    };
+}
+
 ntg_stream_status_enum parseStatus(const ntgcalls::Stream::Status status) {
     switch (status) {
         case ntgcalls::Stream::Playing:
@@ -90,6 +226,12 @@ ntgcalls::MediaDescription parseMediaDescription(const ntg_media_description_str
                     desc.audio->channelCount,
                     std::string(desc.audio->input)
                 );
+                audio->silenceWindow = desc.audio->silenceWindow;
+                if (desc.audio->encoding) {
+                    audio->encoding = parseAudioEncoding(*desc.audio->encoding);
+                }
+                audio->planar = desc.audio->planar;
+                audio->downmixChannels = desc.audio->downmixChannels;
                 break;
             case NTG_FFMPEG:
                 throw ntgcalls::FFmpegError("Not supported");
@@ -106,6 +248,21 @@ ntgcalls::MediaDescription parseMediaDescription(const ntg_media_description_str
                     desc.video->fps,
                     std::string(desc.video->input)
                 );
+                video->pixelFormat = parsePixelFormat(desc.video->pixelFormat);
+                video->adaptiveScaling = desc.video->adaptiveScaling;
+                video->staticRefresh = desc.video->staticRefresh;
+                video->syncTolerance = desc.video->syncTolerance;
+                video->keyframeInterval = desc.video->keyframeInterval;
+                video->timestamped = desc.video->timestamped;
+                if (desc.video->encoding) {
+                    video->encoding = parseVideoEncoding(*desc.video->encoding);
+                }
+                if (desc.video->codecs && desc.video->codecsCount) {
+                    video->codecs.clear();
+                    for (uint8_t i = 0; i < desc.video->codecsCount; i++) {
+                        video->codecs.push_back(parseVideoCodec(desc.video->codecs[i]));
+                    }
+                }
                 break;
             case NTG_FFMPEG:
                 throw ntgcalls::FFmpegError("Not supported");
@@ -119,21 +276,20 @@ ntgcalls::MediaDescription parseMediaDescription(const ntg_media_description_str
 
 uint32_t ntg_init() {
     const uint32_t uid = uidGenerator++;
-    clients[uid] = std::make_shared<ntgcalls::NTgCalls>();
+    clients.insert(uid, std::make_shared<ntgcalls::NTgCalls>());
     return uid;
 }
 
 int ntg_destroy(const uint32_t uid) {
-    if (!clients.contains(uid)) {
+    if (!clients.erase(uid)) {
         return NTG_INVALID_UID;
     }
-    clients.erase(clients.find(uid));
     return 0;
 }
 
-int ntg_get_params(const uint32_t uid, const int64_t chatID, const ntg_media_description_struct desc, char* buffer, const int size) {
+int parseParamsError(const std::exception_ptr& exc) {
     try {
-        return copyAndReturn(safeUID(uid)->createCall(chatID, parseMediaDescription(desc)), buffer, size);
+        std::rethrow_exception(exc);
     } catch (ntgcalls::InvalidUUID&) {
         return NTG_INVALID_UID;
     } catch (ntgcalls::ConnectionError&) {
@@ -151,9 +307,9 @@ int ntg_get_params(const uint32_t uid, const int64_t chatID, const ntg_media_des
     }
 }
 
-int ntg_connect(const uint32_t uid, const int64_t chatID, char* params) {
+int parseConnectError(const std::exception_ptr& exc) {
     try {
-        safeUID(uid)->connect(chatID, std::string(params));
+        std::rethrow_exception(exc);
     } catch (ntgcalls::InvalidUUID&) {
         return NTG_INVALID_UID;
     } catch (ntgcalls::RTMPNeeded&) {
@@ -167,6 +323,48 @@ int ntg_connect(const uint32_t uid, const int64_t chatID, char* params) {
     } catch (...) {
         return NTG_UNKNOWN_EXCEPTION;
     }
+}
+
+int ntg_get_params(const uint32_t uid, const int64_t chatID, const ntg_media_description_struct desc, char* buffer, const int size) {
+    try {
+        return copyAndReturn(safeUID(uid)->createCall(chatID, parseMediaDescription(desc)), buffer, size);
+    } catch (...) {
+        return parseParamsError(std::current_exception());
+    }
+}
+
+int ntg_get_params_async(const uint32_t uid, const int64_t chatID, const ntg_media_description_struct desc, ntg_params_callback callback) {
+    try {
+        safeUID(uid)->createCallAsync(chatID, parseMediaDescription(desc), [uid, chatID, callback](const std::string& params) {
+            callback(uid, chatID, 0, params.c_str());
+        }, [uid, chatID, callback](const std::exception_ptr& exc) {
+            callback(uid, chatID, parseParamsError(exc), nullptr);
+        });
+    } catch (...) {
+        return parseParamsError(std::current_exception());
+    }
+    return 0;
+}
+
+int ntg_connect(const uint32_t uid, const int64_t chatID, char* params) {
+    try {
+        safeUID(uid)->connect(chatID, std::string(params));
+    } catch (...) {
+        return parseConnectError(std::current_exception());
+    }
+    return 0;
+}
+
+int ntg_connect_async(const uint32_t uid, const int64_t chatID, char* params, ntg_connect_callback callback) {
+    try {
+        safeUID(uid)->connectAsync(chatID, std::string(params), [uid, chatID, callback] {
+            callback(uid, chatID, 0);
+        }, [uid, chatID, callback](const std::exception_ptr& exc) {
+            callback(uid, chatID, parseConnectError(exc));
+        });
+    } catch (...) {
+        return parseConnectError(std::current_exception());
+    }
     return 0;
 }
 
@@ -215,6 +413,18 @@ int ntg_resume(const uint32_t uid, const int64_t chatID) {
     }
 }
 
+int ntg_request_keyframe(const uint32_t uid, const int64_t chatID) {
+    try {
+        return !safeUID(uid)->requestKeyframe(chatID);
+    } catch (ntgcalls::InvalidUUID&) {
+        return NTG_INVALID_UID;
+    } catch (ntgcalls::ConnectionNotFound&) {
+        return NTG_CONNECTION_NOT_FOUND;
+    } catch (...) {
+        return NTG_UNKNOWN_EXCEPTION;
+    }
+}
+
 int ntg_mute(const uint32_t uid, const int64_t chatID) {
     try {
         return !safeUID(uid)->mute(chatID);
@@ -278,6 +488,22 @@ auto ntg_get_state(const uint32_t uid, const int64_t chatID, ntg_media_state_str
     return 0;
 }
 
+int ntg_get_stats(const uint32_t uid, const int64_t chatID, ntg_stream_stats_struct* streamStats) {
+    if (!streamStats) {
+        return NTG_NULL_POINTER;
+    }
+    try {
+        *streamStats = parseStreamStats(safeUID(uid)->getStats(chatID));
+    } catch (ntgcalls::InvalidUUID&) {
+        return NTG_INVALID_UID;
+    } catch (ntgcalls::ConnectionNotFound&) {
+        return NTG_CONNECTION_NOT_FOUND;
+    } catch (...) {
+        return NTG_UNKNOWN_EXCEPTION;
+    }
+    return 0;
+}
+
 int ntg_calls(const uint32_t uid, ntg_group_call_struct *buffer, const int size) {
     try {
         const auto callsCpp = safeUID(uid)->calls();
@@ -326,6 +552,60 @@ int ntg_on_upgrade(uint32_t uid, ntg_upgrade_callback callback) {
     return 0;
 }
 
+int ntg_on_reconnect(uint32_t uid, ntg_reconnect_callback callback) {
+    try {
+        safeUID(uid)->onReconnect([uid, callback](const int64_t chatId, const std::string& params) {
+            callback(uid, chatId, params.c_str());
+        });
+    } catch (ntgcalls::InvalidUUID&) {
+        return NTG_INVALID_UID;
+    }
+    return 0;
+}
+
 int ntg_get_version(char* buffer, const int size) {
     return copyAndReturn(NTG_VERSION, buffer, size);
-}
\ No newline at end of file
+}
+
+int ntg_set_factory_config(const ntg_factory_config_struct config) {
+    try {
+        ntgcalls::NTgCalls::setFactoryConfig(wrtc::FactoryConfig{
+            parseAudioProfile(config.audioProfile),
+            config.connectTimeout,
+            config.poolSize,
+            config.certificateRotation,
+            parseIceProfile(config.iceProfile),
+            config.minPort,
+            config.maxPort,
+            config.disableIpv6,
+            config.uplinkBudget,
+            config.sendOnly,
+        });
+    } catch (ntgcalls::ConnectionError&) {
+        return NTG_FACTORY_IN_USE;
+    }
+    return 0;
+}
+
+int ntg_set_warm_pool_size(const uint32_t uid, const uint32_t size) {
+    try {
+        safeUID(uid)->setWarmPoolSize(size);
+    } catch (ntgcalls::InvalidUUID&) {
+        return NTG_INVALID_UID;
+    } catch (...) {
+        return NTG_UNKNOWN_EXCEPTION;
+    }
+    return 0;
+}
+
+int ntg_get_warm_pool_stats(const uint32_t uid, ntg_warm_pool_stats_struct* stats) {
+    if (!stats) {
+        return NTG_NULL_POINTER;
+    }
+    try {
+        *stats = parseWarmPoolStats(safeUID(uid)->getWarmPoolStats());
+    } catch (ntgcalls::InvalidUUID&) {
+        return NTG_INVALID_UID;
+    }
+    return 0;
+}
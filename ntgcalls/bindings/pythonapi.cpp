@@ -13,23 +13,113 @@ namespace py = pybind11;
 #define STRINGIFY(x) #x
 #define MACRO_STRINGIFY(x) STRINGIFY(x)
 
+// Asyncio future completed from the signaling thread, python objects are only touched while holding the GIL
+class AsyncResult {
+    py::object loop, future;
+
+public:
+    // Raises RuntimeError outside a coroutine, there is no loop to complete the future on
+    AsyncResult(): loop(py::module_::import("asyncio").attr("get_running_loop")()), future(loop.attr("create_future")()) {}
+
+    ~AsyncResult() {
+        py::gil_scoped_acquire acquire;
+        future.release().dec_ref();
+        loop.release().dec_ref();
+    }
+
+    [[nodiscard]] py::object awaitable() const {
+        return future;
+    }
+
+    void setResult(const std::function<py::object()>& result) const {
+        py::gil_scoped_acquire acquire;
+        post(py::cpp_function([future = future, result] {
+            if (!future.attr("done")().cast<bool>()) {
+                future.attr("set_result")(result());
+            }
+        }));
+    }
+
+    void setException(const std::exception_ptr& exc) const {
+        py::gil_scoped_acquire acquire;
+        post(py::cpp_function([future = future, exc] {
+            if (future.attr("done")().cast<bool>()) {
+                return;
+            }
+            try {
+                // Goes through the registered translators to get the matching python exception
+                py::cpp_function([exc] {
+                    std::rethrow_exception(exc);
+                })();
+            } catch (py::error_already_set& error) {
+                future.attr("set_exception")(error.value());
+            }
+        }));
+    }
+
+private:
+    // Runs on WebRTC threads with the GIL held, nothing may escape to them
+    void post(const py::cpp_function& callback) const {
+        try {
+            loop.attr("call_soon_threadsafe")(callback);
+        } catch (py::error_already_set&) {
+            // The loop was closed meanwhile, nobody is left to await the result
+        }
+    }
+};
+
 PYBIND11_MODULE(ntgcalls, m) {
     py::class_<ntgcalls::NTgCalls> wrapper(m, "NTgCalls");
     wrapper.def(py::init<>());
-    wrapper.def("create_call", &ntgcalls::NTgCalls::createCall, py::arg("chat_id"), py::arg("media"));
-    wrapper.def("connect", &ntgcalls::NTgCalls::connect, py::arg("chat_id"), py::arg("params"));
-    wrapper.def("change_stream", &ntgcalls::NTgCalls::changeStream, py::arg("chat_id"), py::arg("media"));
+    // These block until WebRTC answers, callbacks into Python from other threads need the GIL meanwhile
+    wrapper.def("create_call", &ntgcalls::NTgCalls::createCall, py::arg("chat_id"), py::arg("media"), py::call_guard<py::gil_scoped_release>());
+    wrapper.def("create_call_async", [](ntgcalls::NTgCalls& self, const int64_t chatId, const ntgcalls::MediaDescription& media) {
+        const auto result = std::make_shared<AsyncResult>();
+        {
+            py::gil_scoped_release release;
+            self.createCallAsync(chatId, media, [result](const std::string& params) {
+                result->setResult([params] {
+                    return py::str(params);
+                });
+            }, [result](const std::exception_ptr& exc) {
+                result->setException(exc);
+            });
+        }
+        return result->awaitable();
+    }, py::arg("chat_id"), py::arg("media"));
+    wrapper.def("connect", &ntgcalls::NTgCalls::connect, py::arg("chat_id"), py::arg("params"), py::call_guard<py::gil_scoped_release>());
+    wrapper.def("connect_async", [](ntgcalls::NTgCalls& self, const int64_t chatId, const std::string& params) {
+        const auto result = std::make_shared<AsyncResult>();
+        {
+            py::gil_scoped_release release;
+            self.connectAsync(chatId, params, [result] {
+                result->setResult([] {
+                    return py::none();
+                });
+            }, [result](const std::exception_ptr& exc) {
+                result->setException(exc);
+            });
+        }
+        return result->awaitable();
+    }, py::arg("chat_id"), py::arg("params"));
+    wrapper.def("change_stream", &ntgcalls::NTgCalls::changeStream, py::arg("chat_id"), py::arg("media"), py::call_guard<py::gil_scoped_release>());
     wrapper.def("pause", &ntgcalls::NTgCalls::pause, py::arg("chat_id"));
     wrapper.def("resume", &ntgcalls::NTgCalls::resume, py::arg("chat_id"));
+    wrapper.def("request_keyframe", &ntgcalls::NTgCalls::requestKeyframe, py::arg("chat_id"));
     wrapper.def("mute", &ntgcalls::NTgCalls::mute, py::arg("chat_id"));
     wrapper.def("unmute", &ntgcalls::NTgCalls::unmute, py::arg("chat_id"));
-    wrapper.def("stop", &ntgcalls::NTgCalls::stop, py::arg("chat_id"));
+    wrapper.def("stop", &ntgcalls::NTgCalls::stop, py::arg("chat_id"), py::call_guard<py::gil_scoped_release>());
     wrapper.def("time", &ntgcalls::NTgCalls::time, py::arg("chat_id"));
     wrapper.def("get_state", &ntgcalls::NTgCalls::getState, py::arg("chat_id"));
+    wrapper.def("get_stats", &ntgcalls::NTgCalls::getStats, py::arg("chat_id"));
     wrapper.def("on_upgrade", &ntgcalls::NTgCalls::onUpgrade);
     wrapper.def("on_stream_end", &ntgcalls::NTgCalls::onStreamEnd);
+    wrapper.def("on_reconnect", &ntgcalls::NTgCalls::onReconnect);
     wrapper.def("calls", &ntgcalls::NTgCalls::calls);
+    wrapper.def("set_warm_pool_size", &ntgcalls::NTgCalls::setWarmPoolSize, py::arg("size"));
+    wrapper.def("get_warm_pool_stats", &ntgcalls::NTgCalls::getWarmPoolStats);
     wrapper.def_static("ping", &ntgcalls::NTgCalls::ping);
+    wrapper.def_static("set_factory_config", &ntgcalls::NTgCalls::setFactoryConfig, py::arg("config"));
 
     py::enum_<ntgcalls::Stream::Type>(m, "StreamType")
             .value("Audio", ntgcalls::Stream::Type::Audio)
@@ -48,14 +138,106 @@ PYBIND11_MODULE(ntgcalls, m) {
             .value("FFmpeg", ntgcalls::BaseMediaDescription::InputMode::FFmpeg)
             .export_values();
 
+    py::enum_<wrtc::AudioProfile>(m, "AudioProfile")
+            .value("Voice", wrtc::AudioProfile::Voice)
+            .value("Music", wrtc::AudioProfile::Music)
+            .export_values();
+
+    py::enum_<wrtc::IceProfile>(m, "IceProfile")
+            .value("Standard", wrtc::IceProfile::Standard)
+            .value("Restricted", wrtc::IceProfile::Restricted)
+            .export_values();
+
+    py::class_<wrtc::FactoryConfig> factoryConfigWrapper(m, "FactoryConfig");
+    factoryConfigWrapper.def(py::init<>());
+    factoryConfigWrapper.def_readwrite("audioProfile", &wrtc::FactoryConfig::audioProfile);
+    factoryConfigWrapper.def_readwrite("connectTimeout", &wrtc::FactoryConfig::connectTimeout);
+    factoryConfigWrapper.def_readwrite("poolSize", &wrtc::FactoryConfig::poolSize);
+    factoryConfigWrapper.def_readwrite("certificateRotation", &wrtc::FactoryConfig::certificateRotation);
+    factoryConfigWrapper.def_readwrite("iceProfile", &wrtc::FactoryConfig::iceProfile);
+    factoryConfigWrapper.def_readwrite("minPort", &wrtc::FactoryConfig::minPort);
+    factoryConfigWrapper.def_readwrite("maxPort", &wrtc::FactoryConfig::maxPort);
+    factoryConfigWrapper.def_readwrite("disableIpv6", &wrtc::FactoryConfig::disableIpv6);
+    factoryConfigWrapper.def_readwrite("uplinkBudget", &wrtc::FactoryConfig::uplinkBudget);
+    factoryConfigWrapper.def_readwrite("sendOnly", &wrtc::FactoryConfig::sendOnly);
+
+    py::enum_<wrtc::PixelFormat>(m, "PixelFormat")
+            .value("I420", wrtc::PixelFormat::I420)
+            .value("NV12", wrtc::PixelFormat::NV12)
+            .value("RGB24", wrtc::PixelFormat::RGB24)
+            .value("RGBA", wrtc::PixelFormat::RGBA)
+            .value("BGRA", wrtc::PixelFormat::BGRA)
+            .value("YUYV", wrtc::PixelFormat::YUYV)
+            .value("UYVY", wrtc::PixelFormat::UYVY)
+            .export_values();
+
+    py::enum_<wrtc::VideoCodec>(m, "VideoCodec")
+            .value("VP8", wrtc::VideoCodec::VP8)
+            .value("VP9", wrtc::VideoCodec::VP9)
+            .value("AV1", wrtc::VideoCodec::AV1)
+            .export_values();
+
+    py::enum_<wrtc::EncoderPreset>(m, "EncoderPreset")
+            .value("Default", wrtc::EncoderPreset::Default)
+            .value("Quality", wrtc::EncoderPreset::Quality)
+            .export_values();
+
+    py::enum_<wrtc::ContentHint>(m, "ContentHint")
+            .value("Generic", wrtc::ContentHint::Generic)
+            .value("Motion", wrtc::ContentHint::Motion)
+            .value("Detail", wrtc::ContentHint::Detail)
+            .value("Text", wrtc::ContentHint::Text)
+            .export_values();
+
+    py::enum_<wrtc::DegradationPreference>(m, "DegradationPreference")
+            .value("Auto", wrtc::DegradationPreference::Auto)
+            .value("Balanced", wrtc::DegradationPreference::Balanced)
+            .value("MaintainFramerate", wrtc::DegradationPreference::MaintainFramerate)
+            .value("MaintainResolution", wrtc::DegradationPreference::MaintainResolution)
+            .value("Disabled", wrtc::DegradationPreference::Disabled)
+            .export_values();
+
     py::class_<ntgcalls::MediaState>(m, "MediaState")
             .def_readonly("muted", &ntgcalls::MediaState::muted)
             .def_readonly("video_stopped", &ntgcalls::MediaState::videoStopped)
             .def_readonly("video_paused", &ntgcalls::MediaState::videoPaused);
 
+    py::class_<ntgcalls::StreamStats>(m, "StreamStats")
+            .def_readonly("silence_ratio", &ntgcalls::StreamStats::silenceRatio)
+            .def_readonly("skipped_frames", &ntgcalls::StreamStats::skippedFrames)
+            .def_readonly("av_offset", &ntgcalls::StreamStats::avOffset);
+
+    py::class_<ntgcalls::WarmPoolStats>(m, "WarmPoolStats")
+            .def_readonly("size", &ntgcalls::WarmPoolStats::size)
+            .def_readonly("ready", &ntgcalls::WarmPoolStats::ready)
+            .def_readonly("hits", &ntgcalls::WarmPoolStats::hits)
+            .def_readonly("misses", &ntgcalls::WarmPoolStats::misses);
+
     py::class_<ntgcalls::BaseMediaDescription> mediaWrapper(m, "BaseMediaDescription");
     mediaWrapper.def_readwrite("input", &ntgcalls::BaseMediaDescription::input);
 
+    py::class_<ntgcalls::AudioEncoding> audioEncodingWrapper(m, "AudioEncoding");
+    audioEncodingWrapper.def(py::init<>());
+    audioEncodingWrapper.def_readwrite("bitrate", &ntgcalls::AudioEncoding::bitrate);
+    audioEncodingWrapper.def_readwrite("complexity", &ntgcalls::AudioEncoding::complexity);
+    audioEncodingWrapper.def_readwrite("stereo", &ntgcalls::AudioEncoding::stereo);
+    audioEncodingWrapper.def_readwrite("fec", &ntgcalls::AudioEncoding::fec);
+    audioEncodingWrapper.def_readwrite("packetTime", &ntgcalls::AudioEncoding::packetTime);
+    audioEncodingWrapper.def_readwrite("minBitrate", &ntgcalls::AudioEncoding::minBitrate);
+    audioEncodingWrapper.def_readwrite("maxBitrate", &ntgcalls::AudioEncoding::maxBitrate);
+
+    py::class_<ntgcalls::VideoEncoding> videoEncodingWrapper(m, "VideoEncoding");
+    videoEncodingWrapper.def(py::init<>());
+    videoEncodingWrapper.def_readwrite("threads", &ntgcalls::VideoEncoding::threads);
+    videoEncodingWrapper.def_readwrite("preset", &ntgcalls::VideoEncoding::preset);
+    videoEncodingWrapper.def_readwrite("contentHint", &ntgcalls::VideoEncoding::contentHint);
+    videoEncodingWrapper.def_readwrite("degradation", &ntgcalls::VideoEncoding::degradation);
+    videoEncodingWrapper.def_readwrite("simulcastLayers", &ntgcalls::VideoEncoding::simulcastLayers);
+    videoEncodingWrapper.def_readwrite("temporalLayers", &ntgcalls::VideoEncoding::temporalLayers);
+    videoEncodingWrapper.def_readwrite("startBitrate", &ntgcalls::VideoEncoding::startBitrate);
+    videoEncodingWrapper.def_readwrite("minBitrate", &ntgcalls::VideoEncoding::minBitrate);
+    videoEncodingWrapper.def_readwrite("maxBitrate", &ntgcalls::VideoEncoding::maxBitrate);
+
     py::class_<ntgcalls::AudioDescription> audioWrapper(m, "AudioDescription", mediaWrapper);
     audioWrapper.def(
             py::init<ntgcalls::BaseMediaDescription::InputMode, uint32_t, uint8_t, uint8_t, std::string>(),
@@ -68,6 +250,10 @@ PYBIND11_MODULE(ntgcalls, m) {
     audioWrapper.def_readwrite("sampleRate", &ntgcalls::AudioDescription::sampleRate);
     audioWrapper.def_readwrite("bitsPerSample", &ntgcalls::AudioDescription::bitsPerSample);
     audioWrapper.def_readwrite("channelCount", &ntgcalls::AudioDescription::channelCount);
+    audioWrapper.def_readwrite("silenceWindow", &ntgcalls::AudioDescription::silenceWindow);
+    audioWrapper.def_readwrite("encoding", &ntgcalls::AudioDescription::encoding);
+    audioWrapper.def_readwrite("planar", &ntgcalls::AudioDescription::planar);
+    audioWrapper.def_readwrite("downmixChannels", &ntgcalls::AudioDescription::downmixChannels);
 
     py::class_<ntgcalls::VideoDescription> videoWrapper(m, "VideoDescription", mediaWrapper);
     videoWrapper.def(
@@ -81,6 +267,14 @@ PYBIND11_MODULE(ntgcalls, m) {
     videoWrapper.def_readwrite("width", &ntgcalls::VideoDescription::width);
     videoWrapper.def_readwrite("height", &ntgcalls::VideoDescription::height);
     videoWrapper.def_readwrite("fps", &ntgcalls::VideoDescription::fps);
+    videoWrapper.def_readwrite("pixelFormat", &ntgcalls::VideoDescription::pixelFormat);
+    videoWrapper.def_readwrite("adaptiveScaling", &ntgcalls::VideoDescription::adaptiveScaling);
+    videoWrapper.def_readwrite("staticRefresh", &ntgcalls::VideoDescription::staticRefresh);
+    videoWrapper.def_readwrite("syncTolerance", &ntgcalls::VideoDescription::syncTolerance);
+    videoWrapper.def_readwrite("keyframeInterval", &ntgcalls::VideoDescription::keyframeInterval);
+    videoWrapper.def_readwrite("timestamped", &ntgcalls::VideoDescription::timestamped);
+    videoWrapper.def_readwrite("encoding", &ntgcalls::VideoDescription::encoding);
+    videoWrapper.def_readwrite("codecs", &ntgcalls::VideoDescription::codecs);
 
     py::class_<ntgcalls::MediaDescription> mediaDescWrapper(m, "MediaDescription");
     mediaDescWrapper.def(
@@ -4,8 +4,14 @@
 
 #include "client.hpp"
 
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <cstdlib>
+#include <future>
+#include <map>
+
 #include "exceptions.hpp"
-#include "wrtc/utils/sync.hpp"
 
 namespace ntgcalls {
     Client::Client() {
@@ -19,107 +25,406 @@ namespace ntgcalls {
         sourceGroups = {};
     }
 
-    GroupCallPayload Client::init() {
+    void Client::prepare(
+        const uint8_t simulcastLayers,
+        const std::function<void()>& onReady,
+        const std::function<void(const std::exception_ptr&)>& onFailed
+    ) {
+        if (connection) {
+            throw ConnectionError("Connection already made");
+        }
         connection = std::make_shared<wrtc::PeerConnection>();
 
         stream->addTracks(connection);
 
-        auto offer = connection->createOffer(true, true);
-        connection->setLocalDescription(offer);
-        return GroupCallPayload(offer);
+        const std::weak_ptr weak(weak_from_this());
+        const auto failed = [onFailed](const std::exception& exc) {
+            onFailed(std::make_exception_ptr(wrtc::RTCException(exc.what())));
+        };
+        const auto receive = !connection->factoryConfig().sendOnly;
+        connection->createOffer(receive, receive, [weak, simulcastLayers, onReady, onFailed, failed](const wrtc::Description& offer) {
+            const auto self = weak.lock();
+            if (!self) {
+                onFailed(std::make_exception_ptr(wrtc::RTCException("Connection closed while creating the offer")));
+                return;
+            }
+            auto sdp = offer.getSdp();
+            if (simulcastLayers > 1) {
+                sdp = wrtc::SdpBuilder::addSimulcast(sdp, simulcastLayers);
+            }
+            try {
+                self->connection->setLocalDescription(wrtc::Description(wrtc::Description::Type::Offer, sdp), [weak, sdp, simulcastLayers, onReady, onFailed] {
+                    const auto self = weak.lock();
+                    if (!self) {
+                        onFailed(std::make_exception_ptr(wrtc::RTCException("Connection closed while creating the offer")));
+                        return;
+                    }
+                    wrtc::Description localDescription(wrtc::Description::Type::Offer, sdp);
+                    self->localPayload = GroupCallPayload(localDescription);
+                    self->preparedLayers = std::max<uint8_t>(simulcastLayers, 1);
+                    onReady();
+                }, failed);
+            } catch (...) {
+                onFailed(std::current_exception());
+            }
+        }, failed);
+    }
+
+    std::string Client::configure(const MediaDescription& config) {
+        stream->setAVStream(config, true);
+        if (config.audio) {
+            audioEncoding = config.audio->encoding;
+        }
+        if (config.video) {
+            videoEncoding = config.video->encoding;
+            videoCodecs = config.video->codecs;
+        }
+        audioSource = localPayload->audioSource;
+        for (const auto &[semantics, ssrcs] : localPayload->ssrcGroups) {
+            for (const auto &ssrc : ssrcs) {
+                if (std::find(sourceGroups.begin(), sourceGroups.end(), ssrc) == sourceGroups.end()) {
+                    sourceGroups.push_back(ssrc);
+                }
+            }
+        }
+        configured = true;
+        return std::string(*localPayload);
+    }
+
+    uint8_t Client::simulcastLayers(const MediaDescription& config) {
+        return std::max<uint8_t>(config.video && config.video->encoding ? config.video->encoding->simulcastLayers : 1, 1);
+    }
+
+    bool Client::isPrepared(const uint8_t simulcastLayers) const {
+        return connection && localPayload && !configured && preparedLayers == simulcastLayers;
     }
 
     std::string Client::init(const MediaDescription& config) {
-        if (connection) {
+        std::promise<std::string> promise;
+        init(config, [&promise](const std::string& params) {
+            promise.set_value(params);
+        }, [&promise](const std::exception_ptr& exc) {
+            promise.set_exception(exc);
+        });
+        return promise.get_future().get();
+    }
+
+    void Client::init(
+        const MediaDescription& config,
+        const std::function<void(const std::string&)>& onSuccess,
+        const std::function<void(const std::exception_ptr&)>& onFailed
+    ) {
+        if (connection && !isPrepared(simulcastLayers(config))) {
             throw ConnectionError("Connection already made");
         }
 
-        const auto res = init();
-        stream->setAVStream(config, true);
-        audioSource = res.audioSource;
-        for (const auto &ssrc : res.sourceGroups) {
-            sourceGroups.push_back(ssrc);
+        Stream::checkConfig(config);
+
+        if (connection) {
+            // Offer already applied by the warm pool, only the media is left
+            onSuccess(configure(config));
+            return;
+        }
+
+        const std::weak_ptr weak(weak_from_this());
+        prepare(simulcastLayers(config), [weak, config, onSuccess, onFailed] {
+            const auto self = weak.lock();
+            if (!self) {
+                onFailed(std::make_exception_ptr(wrtc::RTCException("Connection closed while creating the offer")));
+                return;
+            }
+            std::string params;
+            try {
+                params = self->configure(config);
+            } catch (...) {
+                onFailed(std::current_exception());
+                return;
+            }
+            onSuccess(params);
+        }, onFailed);
+    }
+
+    wrtc::OpusParams Client::opusParams() const {
+        wrtc::OpusParams params;
+        if (audioEncoding) {
+            params.stereo = audioEncoding->stereo;
+            params.maxBitrate = audioEncoding->bitrate;
+            params.complexity = audioEncoding->complexity;
+            params.fec = audioEncoding->fec;
+            params.packetTime = audioEncoding->packetTime;
+        } else if (connection->factoryConfig().audioProfile == wrtc::AudioProfile::Music) {
+            params.stereo = true;
+            params.maxBitrate = 128000;
+        }
+        return params;
+    }
+
+    wrtc::VideoParams Client::videoParams(const json& payloadTypes) const {
+        wrtc::VideoParams params;
+        if (!videoCodecs.empty()) {
+            params.codecs = videoCodecs;
+        }
+        if (videoEncoding) {
+            params.threads = videoEncoding->threads;
+            params.preset = videoEncoding->preset;
+            if (videoEncoding->startBitrate) {
+                params.startBitrate = videoEncoding->startBitrate / 1000;
+            }
+            params.minBitrate = videoEncoding->minBitrate / 1000;
+            params.maxBitrate = videoEncoding->maxBitrate / 1000;
+        }
+        params.controlId = connection->encoderControl()->id();
+        if (!payloadTypes.is_array()) {
+            return params;
+        }
+        const std::map<std::string, wrtc::VideoCodec> names = {
+            {"VP8", wrtc::VideoCodec::VP8},
+            {"VP9", wrtc::VideoCodec::VP9},
+            {"AV1", wrtc::VideoCodec::AV1},
+        };
+        std::map<int, int> rtxPayloadTypes;
+        for (const auto& item : payloadTypes) {
+            auto name = item.value("name", std::string());
+            std::transform(name.begin(), name.end(), name.begin(), [](const unsigned char c) {
+                return static_cast<char>(std::toupper(c));
+            });
+            const auto id = item.value("id", 0);
+            if (name == "RTX") {
+                const auto apt = item.value("parameters", json::object()).value("apt", json());
+                if (apt.is_string()) {
+                    rtxPayloadTypes[std::atoi(apt.get<std::string>().c_str())] = id;
+                } else if (apt.is_number_integer()) {
+                    rtxPayloadTypes[apt.get<int>()] = id;
+                }
+            } else if (const auto codec = names.find(name); codec != names.end()) {
+                // The first entry wins, later ones are alternative profiles of the same codec
+                params.payloadTypes.emplace(codec->second, std::pair(id, 0));
+            }
         }
-        return std::string(res);
+        for (auto& [codec, ids] : params.payloadTypes) {
+            if (const auto rtx = rtxPayloadTypes.find(ids.first); rtx != rtxPayloadTypes.end()) {
+                ids.second = rtx->second;
+            }
+        }
+        auto codecs = params.codecs;
+        std::erase_if(codecs, [&params](const wrtc::VideoCodec codec) {
+            return !params.payloadTypes.contains(codec);
+        });
+        if (!codecs.empty()) {
+            params.codecs = codecs;
+        } else if (!videoCodecs.empty()) {
+            throw InvalidParams("None of the video codecs is supported by the server");
+        } else {
+            // No video was requested, the defaults only fill the video section
+            params.payloadTypes.clear();
+        }
+        return params;
     }
 
     auto Client::changeStream(const MediaDescription& config) const -> void {
-        stream->setAVStream(config);
+        if (!configured || !config.audio) {
+            stream->setAVStream(config);
+            return;
+        }
+        auto media = config;
+        if (!media.audio->encoding) {
+            media.audio->encoding = audioEncoding;
+        } else {
+            const auto current = audioEncoding.value_or(AudioEncoding());
+            const auto& next = media.audio->encoding.value();
+            // Only the send bitrate bounds are applied through the sender parameters
+            if (!audioEncoding || next.bitrate != current.bitrate || next.complexity != current.complexity ||
+                next.stereo != current.stereo || next.fec != current.fec || next.packetTime != current.packetTime) {
+                throw InvalidParams("Audio encoding is negotiated when the call is created, only its min and max bitrate can change");
+            }
+        }
+        stream->setAVStream(media);
     }
 
-    void Client::connect(const std::string& jsonData) const {
+    wrtc::Description Client::remoteDescription(const std::string& jsonData) const {
+        auto data = json::parse(jsonData);
+        if (!data["rtmp"].is_null()) {
+            throw RTMPNeeded("Needed rtmp connection");
+        }
+        if (data["transport"].is_null()) {
+            throw InvalidParams("Transport not found");
+        }
+        const auto video = videoParams(data["video"]["payload-types"]);
+        data = data["transport"];
+        wrtc::Conference conference;
         try {
-            auto data = json::parse(jsonData);
-            if (!data["rtmp"].is_null()) {
-                throw RTMPNeeded("Needed rtmp connection");
+            conference = {
+                {
+                    data["ufrag"].get<std::string>(),
+                    data["pwd"].get<std::string>()
+                },
+                audioSource,
+                sourceGroups,
+                opusParams(),
+                video
+            };
+            for (const auto& item : data["fingerprints"].items()) {
+                conference.transport.fingerprints.push_back({
+                    item.value()["hash"],
+                    item.value()["fingerprint"],
+                });
             }
-            if (data["transport"].is_null()) {
-                throw InvalidParams("Transport not found");
+            for (const auto& item : data["candidates"].items()) {
+                conference.transport.candidates.push_back({
+                    item.value()["generation"].get<std::string>(),
+                    item.value()["component"].get<std::string>(),
+                    item.value()["protocol"].get<std::string>(),
+                    item.value()["port"].get<std::string>(),
+                    item.value()["ip"].get<std::string>(),
+                    item.value()["foundation"].get<std::string>(),
+                    item.value()["id"].get<std::string>(),
+                    item.value()["priority"].get<std::string>(),
+                    item.value()["type"].get<std::string>(),
+                    item.value()["network"].get<std::string>()
+                });
             }
-            data = data["transport"];
-            wrtc::Conference conference;
-            try {
-                conference = {
-                    {
-                        data["ufrag"].get<std::string>(),
-                        data["pwd"].get<std::string>()
-                    },
-                    audioSource,
-                    sourceGroups
-                };
-                for (const auto& item : data["fingerprints"].items()) {
-                    conference.transport.fingerprints.push_back({
-                        item.value()["hash"],
-                        item.value()["fingerprint"],
-                    });
-                }
-                for (const auto& item : data["candidates"].items()) {
-                    conference.transport.candidates.push_back({
-                        item.value()["generation"].get<std::string>(),
-                        item.value()["component"].get<std::string>(),
-                        item.value()["protocol"].get<std::string>(),
-                        item.value()["port"].get<std::string>(),
-                        item.value()["ip"].get<std::string>(),
-                        item.value()["foundation"].get<std::string>(),
-                        item.value()["id"].get<std::string>(),
-                        item.value()["priority"].get<std::string>(),
-                        item.value()["type"].get<std::string>(),
-                        item.value()["network"].get<std::string>()
-                    });
-                }
-            } catch (...) {
-                throw InvalidParams("Invalid transport");
-            }
-
-            const auto remoteDescription = wrtc::Description(
-                wrtc::Description::Type::Answer,
-                wrtc::SdpBuilder::fromConference(conference)
-            );
-            connection->setRemoteDescription(remoteDescription);
-
-            wrtc::Sync<void> waitConnection;
-            connection->onIceStateChange([&waitConnection](const wrtc::IceState state) {
-                switch (state) {
-                    case wrtc::IceState::Connected:
-                        waitConnection.onSuccess();
-                        break;
-                    case wrtc::IceState::Disconnected:
-                    case wrtc::IceState::Failed:
-                    case wrtc::IceState::Closed:
-                        waitConnection.onFailed(ConnectionError("Connection failed to Telegram WebRTC"));
-                        break;
-                    default:
-                        break;
-                }
+        } catch (...) {
+            throw InvalidParams("Invalid transport");
+        }
+        return {
+            wrtc::Description::Type::Answer,
+            wrtc::SdpBuilder::fromConference(conference)
+        };
+    }
+
+    void Client::connect(const std::string& jsonData) {
+        try {
+            std::promise<void> promise;
+            connect(jsonData, [&promise] {
+                promise.set_value();
+            }, [&promise](const std::exception_ptr& exc) {
+                promise.set_exception(exc);
             });
-            waitConnection.wait();
-            connection->onIceStateChange(nullptr);
-            stream->start();
+            promise.get_future().get();
         } catch (const std::exception &exc) {
             throw wrtc::RTCException(exc.what());
         }
     }
 
+    void Client::connect(
+        const std::string& jsonData,
+        const std::function<void()>& onConnected,
+        const std::function<void(const std::exception_ptr&)>& onFailed
+    ) {
+        const auto description = remoteDescription(jsonData);
+        restarting = false;
+
+        // Whichever of connected, failed or timed out comes first wins, later outcomes are ignored
+        const auto done = std::make_shared<std::atomic_bool>(false);
+        const auto failed = [done, onFailed](const std::exception_ptr& exc) {
+            if (!done->exchange(true)) {
+                onFailed(exc);
+            }
+        };
+        const std::weak_ptr weak(weak_from_this());
+        connection->onIceStateChange([weak, done, onConnected, failed](const wrtc::IceState state) {
+            const auto self = weak.lock();
+            if (!self) {
+                return;
+            }
+            if (self->connected) {
+                // A reconnect still answers its own connect, but a failed one must not stop the recovery
+                if (state == wrtc::IceState::Connected && !done->exchange(true)) {
+                    onConnected();
+                } else if (state == wrtc::IceState::Failed || state == wrtc::IceState::Closed) {
+                    failed(std::make_exception_ptr(ConnectionError("Connection failed to Telegram WebRTC")));
+                }
+                self->recover(state);
+                return;
+            }
+            switch (state) {
+                case wrtc::IceState::Connected:
+                    if (!done->exchange(true)) {
+                        self->connected = true;
+                        self->stream->start();
+                        onConnected();
+                    }
+                    break;
+                case wrtc::IceState::Disconnected:
+                case wrtc::IceState::Failed:
+                case wrtc::IceState::Closed:
+                    failed(std::make_exception_ptr(ConnectionError("Connection failed to Telegram WebRTC")));
+                    break;
+                default:
+                    break;
+            }
+        });
+        if (const auto timeout = connection->factoryConfig().connectTimeout) {
+            connection->postDelayed(std::chrono::milliseconds(timeout), [failed] {
+                failed(std::make_exception_ptr(ConnectionError("Connection to Telegram WebRTC timed out")));
+            });
+        }
+        connection->setRemoteDescription(description, [] {}, [failed](const std::exception& exc) {
+            failed(std::make_exception_ptr(wrtc::RTCException(exc.what())));
+        });
+    }
+
+    void Client::recover(const wrtc::IceState state) {
+        const auto change = ++iceChanges;
+        switch (state) {
+            case wrtc::IceState::Disconnected:
+                // Consent checks often recover on their own, only restart if still disconnected after a grace period
+                connection->postDelayed(std::chrono::seconds(3), [weak = weak_from_this(), change] {
+                    if (const auto self = weak.lock(); self && self->iceChanges == change) {
+                        self->restartIce();
+                    }
+                });
+                break;
+            case wrtc::IceState::Failed:
+                restartIce();
+                break;
+            default:
+                break;
+        }
+    }
+
+    void Client::restartIce() {
+        if (restarting.exchange(true)) {
+            return;
+        }
+        const std::weak_ptr weak(weak_from_this());
+        const auto failed = [weak](const std::exception&) {
+            if (const auto self = weak.lock()) {
+                self->restarting = false;
+            }
+        };
+        try {
+            // New ICE credentials, same tracks and SSRCs, so the server keeps routing the same sources
+            connection->restartIce();
+            const auto receive = !connection->factoryConfig().sendOnly;
+            connection->createOffer(receive, receive, [weak, failed](const wrtc::Description& offer) {
+                const auto self = weak.lock();
+                if (!self) {
+                    return;
+                }
+                auto sdp = offer.getSdp();
+                if (self->preparedLayers > 1) {
+                    sdp = wrtc::SdpBuilder::addSimulcast(sdp, self->localPayload->ssrcGroups);
+                }
+                try {
+                    self->connection->setLocalDescription(wrtc::Description(wrtc::Description::Type::Offer, sdp), [weak, sdp] {
+                        const auto self = weak.lock();
+                        if (!self) {
+                            return;
+                        }
+                        wrtc::Description localDescription(wrtc::Description::Type::Offer, sdp);
+                        self->localPayload = GroupCallPayload(localDescription);
+                        (void) self->onReconnectNeeded(std::string(*self->localPayload));
+                    }, failed);
+                } catch (...) {
+                    self->restarting = false;
+                }
+            }, failed);
+        } catch (...) {
+            restarting = false;
+        }
+    }
+
     bool Client::pause() const {
         return stream->pause();
     }
@@ -128,6 +433,10 @@ namespace ntgcalls {
         return stream->resume();
     }
 
+    bool Client::requestKeyframe() const {
+        return stream->requestKeyframe();
+    }
+
     bool Client::mute() const {
         return stream->mute();
     }
@@ -149,6 +458,10 @@ namespace ntgcalls {
         stream->onUpgrade(callback);
     }
 
+    void Client::onReconnect(const std::function<void(const std::string&)>& callback) {
+        onReconnectNeeded = callback;
+    }
+
     uint64_t Client::time() const {
         return stream->time();
     }
@@ -157,6 +470,10 @@ namespace ntgcalls {
         return stream->getState();
     }
 
+    StreamStats Client::getStats() const {
+        return stream->getStats();
+    }
+
     auto Client::status() const -> Stream::Status {
         return stream->status();
     }
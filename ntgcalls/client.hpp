@@ -4,6 +4,9 @@
 
 #pragma once
 
+#include <atomic>
+#include <exception>
+#include <memory>
 #include <string>
 #include <wrtc/wrtc.hpp>
 
@@ -14,29 +17,81 @@
 namespace ntgcalls {
     using nlohmann::json;
 
-    class Client {
+    class Client: public std::enable_shared_from_this<Client> {
         std::shared_ptr<wrtc::PeerConnection> connection;
         wrtc::SSRC audioSource = 0;
         std::vector<wrtc::SSRC> sourceGroups = {};
         std::shared_ptr<Stream> stream;
+        std::optional<AudioEncoding> audioEncoding;
+        std::optional<VideoEncoding> videoEncoding;
+        std::vector<wrtc::VideoCodec> videoCodecs;
+        std::optional<GroupCallPayload> localPayload;
+        uint8_t preparedLayers = 0;
+        bool configured = false;
+        wrtc::synchronized_callback<std::string> onReconnectNeeded;
+        // Set when ICE first connects, reconnects after an ICE restart keep it so the recovery stays installed
+        std::atomic_bool connected = false;
+        std::atomic_bool restarting = false;
+        // Bumped on every ICE state change after connecting, a pending restart only runs if nothing changed since
+        std::atomic_uint32_t iceChanges = 0;
 
-        GroupCallPayload init();
+        std::string configure(const MediaDescription& config);
+
+        [[nodiscard]] wrtc::Description remoteDescription(const std::string& jsonData) const;
+
+        [[nodiscard]] wrtc::OpusParams opusParams() const;
+
+        // Codecs missing from the payload types of the join response are left out, the rest keep the server ids
+        [[nodiscard]] wrtc::VideoParams videoParams(const json& payloadTypes) const;
+
+        void recover(wrtc::IceState state);
+
+        void restartIce();
 
     public:
         Client();
 
         ~Client();
 
+        // Creates the connection and applies the local offer, so init only has to set up the media
+        void prepare(
+            uint8_t simulcastLayers,
+            const std::function<void()>& onReady,
+            const std::function<void(const std::exception_ptr&)>& onFailed
+        );
+
+        [[nodiscard]] bool isPrepared(uint8_t simulcastLayers) const;
+
+        static uint8_t simulcastLayers(const MediaDescription& config);
+
         std::string init(const MediaDescription& config);
 
-        void connect(const std::string& jsonData) const;
+        // Invalid parameters are thrown right away, everything after the offer is reported through the callbacks
+        void init(
+            const MediaDescription& config,
+            const std::function<void(const std::string&)>& onSuccess,
+            const std::function<void(const std::exception_ptr&)>& onFailed
+        );
+
+        // Also used to apply the new transport after onReconnect, the stream keeps running meanwhile
+        void connect(const std::string& jsonData);
+
+        // Completes when ICE connects, fails, or the factory connect timeout expires
+        void connect(
+            const std::string& jsonData,
+            const std::function<void()>& onConnected,
+            const std::function<void(const std::exception_ptr&)>& onFailed
+        );
 
+        // The Opus settings were negotiated with the call, an unset audio encoding keeps them and a different one is rejected
         void changeStream(const MediaDescription& config) const;
 
         [[nodiscard]] bool pause() const;
 
         [[nodiscard]] bool resume() const;
 
+        [[nodiscard]] bool requestKeyframe() const;
+
         [[nodiscard]] bool mute() const;
 
         [[nodiscard]] bool unmute() const;
@@ -47,10 +102,15 @@ namespace ntgcalls {
 
         [[nodiscard]] MediaState getState() const;
 
+        [[nodiscard]] StreamStats getStats() const;
+
         [[nodiscard]] Stream::Status status() const;
 
         void onUpgrade(const std::function<void(MediaState)>& callback) const;
 
         void onStreamEnd(const std::function<void(Stream::Type)>& callback) const;
+
+        // Called with new join params after an ICE restart, the answer to them goes back through connect
+        void onReconnect(const std::function<void(const std::string&)>& callback);
     };
 }
\ No newline at end of file
@@ -12,21 +12,26 @@ namespace ntgcalls {
 
     BaseReader::~BaseReader() {
         BaseReader::close();
-        promise = nullptr;
+        filling = {};
         dispatchQueue = nullptr;
         readChunks = 0;
         nextBuffer.clear();
     }
 
-    wrtc::binary BaseReader::read(int64_t size) {
+    wrtc::binary BaseReader::read(int64_t size, const bool wait) {
         wrtc::binary res = nullptr;
         if (dispatchQueue != nullptr) {
-            promise = std::make_shared<std::promise<void>>();
+            std::shared_future<void> filled;
+            mutex.lock();
             if (!_eof && nextBuffer.size() <= 4 && !running) {
                 running = true;
-                dispatchQueue->dispatch([this, size] {
+                const auto promise = std::make_shared<std::promise<void>>();
+                filling = promise->get_future().share();
+                dispatchQueue->dispatch([this, size, promise] {
                     try {
+                        mutex.lock();
                         const auto availableSpace = 10 - nextBuffer.size();
+                        mutex.unlock();
                         for (int i = 0; i < availableSpace; i++) {
                             if (auto tmp = readInternal(size); tmp != nullptr) {
                                 mutex.lock();
@@ -38,11 +43,15 @@ namespace ntgcalls {
                         _eof = true;
                     }
                     running = false;
-                    if (promise != nullptr) promise->set_value();
+                    promise->set_value();
                 });
             }
-            if (nextBuffer.empty() && !_eof) {
-                if (promise != nullptr) promise->get_future().wait();
+            if (nextBuffer.empty() && !_eof && wait) {
+                filled = filling;
+            }
+            mutex.unlock();
+            if (filled.valid()) {
+                filled.wait();
             }
             mutex.lock();
             if (!nextBuffer.empty()) {
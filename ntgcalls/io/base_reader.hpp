@@ -5,6 +5,8 @@
 #pragma once
 
 
+#include <atomic>
+#include <future>
 #include <vector>
 
 #include <wrtc/wrtc.hpp>
@@ -13,10 +15,11 @@
 namespace ntgcalls {
     class BaseReader {
         std::vector<wrtc::binary> nextBuffer;
-        bool _eof = false, running = false;
+        std::atomic_bool _eof = false, running = false;
         std::shared_ptr<DispatchQueue> dispatchQueue;
         std::recursive_mutex mutex;
-        std::shared_ptr<std::promise<void>> promise;
+        // Completed by the fill that is running, each fill owns its own promise
+        std::shared_future<void> filling;
 
     protected:
         int64_t readChunks = 0;
@@ -28,7 +31,7 @@ namespace ntgcalls {
         virtual wrtc::binary readInternal(int64_t size) = 0;
 
     public:
-        wrtc::binary read(int64_t size);
+        wrtc::binary read(int64_t size, bool wait = true);
 
         [[nodiscard]] bool eof() const;
 
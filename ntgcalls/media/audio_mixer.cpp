@@ -0,0 +1,168 @@
+//
+// Created by Laky64 on 18/10/2026.
+//
+
+#include "audio_mixer.hpp"
+
+#include <algorithm>
+
+#include "../exceptions.hpp"
+
+namespace ntgcalls {
+    std::vector<float> AudioMixer::stereoCoefficients(const uint8_t channels) {
+        constexpr float k = 0.70710678f;
+        // Left and right gains of every input channel
+        std::vector<std::pair<float, float>> gains;
+        switch (channels) {
+            case 1:
+                gains = {{1, 1}};
+                break;
+            case 2:
+                gains = {{1, 0}, {0, 1}};
+                break;
+            case 3:
+                gains = {{1, 0}, {0, 1}, {k, k}};
+                break;
+            case 4:
+                gains = {{1, 0}, {0, 1}, {k, 0}, {0, k}};
+                break;
+            case 5:
+                gains = {{1, 0}, {0, 1}, {k, k}, {k, 0}, {0, k}};
+                break;
+            case 6:
+                gains = {{1, 0}, {0, 1}, {k, k}, {0, 0}, {k, 0}, {0, k}};
+                break;
+            case 7:
+                gains = {{1, 0}, {0, 1}, {k, k}, {0, 0}, {k * k, k * k}, {k, 0}, {0, k}};
+                break;
+            case 8:
+                gains = {{1, 0}, {0, 1}, {k, k}, {0, 0}, {k, 0}, {0, k}, {k, 0}, {0, k}};
+                break;
+            default:
+                throw InvalidParams("Only 1 to 8 audio channels are supported");
+        }
+        float leftSum = 0, rightSum = 0;
+        for (const auto& [left, right] : gains) {
+            leftSum += left;
+            rightSum += right;
+        }
+        std::vector<float> res(2 * channels);
+        for (uint8_t c = 0; c < channels; c++) {
+            res[c] = gains[c].first / leftSum;
+            res[channels + c] = gains[c].second / rightSum;
+        }
+        return res;
+    }
+
+    void AudioMixer::setConfig(const uint8_t inputChannelCount, const uint8_t outputChannelCount, const bool isPlanar) {
+        if (outputChannelCount < 1 || outputChannelCount > 2) {
+            throw InvalidParams("Audio can only be downmixed to 1 or 2 channels");
+        }
+        inputChannels = inputChannelCount;
+        outputChannels = outputChannelCount;
+        planar = isPlanar;
+        coefficients.clear();
+        const auto stereo = stereoCoefficients(inputChannels);
+        if (outputChannels == 2) {
+            coefficients = stereo;
+        } else {
+            coefficients.resize(inputChannels);
+            for (uint8_t c = 0; c < inputChannels; c++) {
+                coefficients[c] = (stereo[c] + stereo[inputChannels + c]) / 2;
+            }
+        }
+    }
+
+    bool AudioMixer::passthrough() const {
+        return inputChannels == outputChannels && (!planar || inputChannels == 1);
+    }
+
+    template <uint8_t N>
+    void AudioMixer::downmixInterleaved(const int16_t* src, int16_t* dst, const size_t samples) const {
+        // N is known at compile time, so the channel loops unroll and the sample loop vectorizes
+        const float* gains = coefficients.data();
+        for (size_t i = 0; i < samples; i++) {
+            const int16_t* in = src + i * N;
+            for (uint8_t o = 0; o < outputChannels; o++) {
+                float acc = 0;
+                for (uint8_t c = 0; c < N; c++) {
+                    acc += gains[o * N + c] * static_cast<float>(in[c]);
+                }
+                dst[i * outputChannels + o] = static_cast<int16_t>(std::clamp(acc, -32768.0f, 32767.0f));
+            }
+        }
+    }
+
+    void AudioMixer::downmixPlanar(const int16_t* src, int16_t* dst, const size_t samples) const {
+        accumulator.resize(samples);
+        for (uint8_t o = 0; o < outputChannels; o++) {
+            std::fill(accumulator.begin(), accumulator.end(), 0.0f);
+            float* acc = accumulator.data();
+            for (uint8_t c = 0; c < inputChannels; c++) {
+                const float gain = coefficients[o * inputChannels + c];
+                const int16_t* plane = src + c * samples;
+                for (size_t i = 0; i < samples; i++) {
+                    acc[i] += gain * static_cast<float>(plane[i]);
+                }
+            }
+            for (size_t i = 0; i < samples; i++) {
+                dst[i * outputChannels + o] = static_cast<int16_t>(std::clamp(acc[i], -32768.0f, 32767.0f));
+            }
+        }
+    }
+
+    void AudioMixer::interleave(const int16_t* src, int16_t* dst, const size_t samples, const uint8_t channels) {
+        for (uint8_t c = 0; c < channels; c++) {
+            const int16_t* plane = src + c * samples;
+            for (size_t i = 0; i < samples; i++) {
+                dst[i * channels + c] = plane[i];
+            }
+        }
+    }
+
+    wrtc::binary AudioMixer::process(const wrtc::binary& sample, const size_t samples) const {
+        if (passthrough()) {
+            return sample;
+        }
+        const auto src = reinterpret_cast<const int16_t*>(sample.get());
+        auto res = std::make_shared<uint8_t[]>(samples * outputChannels * sizeof(int16_t));
+        const auto dst = reinterpret_cast<int16_t*>(res.get());
+        if (inputChannels == outputChannels) {
+            interleave(src, dst, samples, inputChannels);
+            return res;
+        }
+        if (planar) {
+            downmixPlanar(src, dst, samples);
+            return res;
+        }
+        switch (inputChannels) {
+            case 1:
+                downmixInterleaved<1>(src, dst, samples);
+                break;
+            case 2:
+                downmixInterleaved<2>(src, dst, samples);
+                break;
+            case 3:
+                downmixInterleaved<3>(src, dst, samples);
+                break;
+            case 4:
+                downmixInterleaved<4>(src, dst, samples);
+                break;
+            case 5:
+                downmixInterleaved<5>(src, dst, samples);
+                break;
+            case 6:
+                downmixInterleaved<6>(src, dst, samples);
+                break;
+            case 7:
+                downmixInterleaved<7>(src, dst, samples);
+                break;
+            case 8:
+                downmixInterleaved<8>(src, dst, samples);
+                break;
+            default:
+                break;
+        }
+        return res;
+    }
+} // ntgcalls
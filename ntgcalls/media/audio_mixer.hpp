@@ -0,0 +1,45 @@
+//
+// Created by Laky64 on 18/10/2026.
+//
+
+#pragma once
+
+// DOWNMIX SPECIFICATION
+// Input Channels: 1-8, WAVE order (FL FR FC LFE BL BR SL SR)
+// 3: FL FR FC
+// 4: FL FR BL BR
+// 5: FL FR FC BL BR
+// 6: FL FR FC LFE BL BR
+// 7: FL FR FC LFE BC SL SR
+// 8: FL FR FC LFE BL BR SL SR
+// Coefficients: ITU-R BS.775, LFE dropped, normalized to avoid clipping
+// Output Channels: 1 or 2
+
+#include <vector>
+#include <wrtc/wrtc.hpp>
+
+namespace ntgcalls {
+    class AudioMixer {
+        uint8_t inputChannels = 0, outputChannels = 0;
+        bool planar = false;
+        // outputChannels rows of inputChannels gains
+        std::vector<float> coefficients;
+        mutable std::vector<float> accumulator;
+
+        static std::vector<float> stereoCoefficients(uint8_t channels);
+
+        template <uint8_t N>
+        void downmixInterleaved(const int16_t* src, int16_t* dst, size_t samples) const;
+
+        void downmixPlanar(const int16_t* src, int16_t* dst, size_t samples) const;
+
+        static void interleave(const int16_t* src, int16_t* dst, size_t samples, uint8_t channels);
+
+    public:
+        void setConfig(uint8_t inputChannelCount, uint8_t outputChannelCount, bool isPlanar);
+
+        [[nodiscard]] bool passthrough() const;
+
+        [[nodiscard]] wrtc::binary process(const wrtc::binary& sample, size_t samples) const;
+    };
+} // ntgcalls
@@ -4,6 +4,8 @@
 
 #include "audio_streamer.hpp"
 
+#include "../exceptions.hpp"
+
 namespace ntgcalls {
     AudioStreamer::AudioStreamer() {
         audio = std::make_shared<wrtc::RTCAudioSource>();
@@ -13,34 +15,90 @@ namespace ntgcalls {
         bps = 0;
         rate = 0;
         channels = 0;
+        inputChannels = 0;
         audio = nullptr;
     }
 
-    wrtc::MediaStreamTrack *AudioStreamer::createTrack() {
-        return audio->createTrack();
+    wrtc::MediaStreamTrack *AudioStreamer::createTrack(const rtc::scoped_refptr<wrtc::PeerConnectionFactory>& factory) {
+        return audio->createTrack(factory);
     }
 
     std::chrono::nanoseconds AudioStreamer::frameTime() {
-        return std::chrono::milliseconds(10); // ms
+        return std::chrono::milliseconds(packetTime); // ms
     }
 
     void AudioStreamer::sendData(const wrtc::binary& sample) {
+        auto timestamp = captureTime();
         BaseStreamer::sendData(sample);
-        auto event = wrtc::RTCOnDataEvent(sample, frameSize() / (2 * channels));
-        event.channelCount = channels;
-        event.sampleRate = rate;
-        event.bitsPerSample = bps;
-        audio->OnData(event);
+        const auto size = chunkSize();
+        const auto dataSize = size * (packetTime / 10);
+        const auto data = mixer.process(sample, rate / 100 * (packetTime / 10));
+        if (!silence.process(data, dataSize, frameTime())) {
+            // Opus DTX already keeps the receiver fed with comfort noise
+            return;
+        }
+        // WebRTC only accepts 10ms of audio at a time
+        for (int64_t offset = 0; offset < dataSize; offset += size) {
+            auto event = wrtc::RTCOnDataEvent(wrtc::binary(data, data.get() + offset), size / (2 * channels));
+            event.channelCount = channels;
+            event.sampleRate = rate;
+            event.bitsPerSample = bps;
+            event.timestamp = timestamp;
+            audio->OnData(event);
+            timestamp += std::chrono::milliseconds(10);
+        }
     }
 
-    int64_t AudioStreamer::frameSize() {
+    int64_t AudioStreamer::chunkSize() const {
         return rate * bps / 8 / 100 * channels;
     }
 
-    void AudioStreamer::setConfig(const uint32_t sampleRate, const uint8_t bitsPerSample, const uint8_t channelCount) {
+    int64_t AudioStreamer::frameSize() {
+        return rate * bps / 8 / 100 * inputChannels * (packetTime / 10);
+    }
+
+    void AudioStreamer::checkConfig(const AudioDescription& config) {
+        const auto encoding = config.encoding.value_or(AudioEncoding());
+        switch (encoding.packetTime) {
+            case 10:
+            case 20:
+            case 40:
+            case 60:
+                break;
+            default:
+                throw InvalidParams("Packet time must be 10, 20, 40 or 60 ms");
+        }
+        if (encoding.complexity < -1 || encoding.complexity > 10) {
+            throw InvalidParams("Opus complexity must be between 0 and 10, or -1 for the default");
+        }
+        if (encoding.bitrate && (encoding.bitrate < 6000 || encoding.bitrate > 510000)) {
+            throw InvalidParams("Opus bitrate must be between 6000 and 510000 bps");
+        }
+        if (encoding.minBitrate && encoding.maxBitrate && encoding.minBitrate > encoding.maxBitrate) {
+            throw InvalidParams("Audio minimum bitrate must not exceed the maximum one");
+        }
+        if (config.channelCount < 1 || config.channelCount > 8) {
+            throw InvalidParams("Only 1 to 8 audio channels are supported");
+        }
+        if (config.downmixChannels > 2) {
+            throw InvalidParams("Audio can only be downmixed to 1 or 2 channels");
+        }
+    }
+
+    void AudioStreamer::setConfig(const AudioDescription& config) {
+        const auto encoding = config.encoding.value_or(AudioEncoding());
+        const uint8_t outputChannels = config.downmixChannels ? config.downmixChannels : std::min<uint8_t>(config.channelCount, 2);
+        mixer.setConfig(config.channelCount, outputChannels, config.planar);
         clear();
-        bps = bitsPerSample;
-        rate = sampleRate;
-        channels = channelCount;
+        bps = config.bitsPerSample;
+        rate = config.sampleRate;
+        inputChannels = config.channelCount;
+        channels = outputChannels;
+        packetTime = encoding.packetTime;
+        silence.setWindow(std::chrono::milliseconds(config.silenceWindow));
+    }
+
+    double AudioStreamer::silenceRatio() const {
+        return silence.ratio();
     }
 }
@@ -5,33 +5,45 @@
 #pragma once
 
 // PCM16L AUDIO CODEC SPECIFICATION
-// Frame Time: 10ms
+// Frame Time: 10ms (or the configured packet time, pushed to WebRTC in 10ms chunks)
 // Max SampleRate: 48000
 // Max BitsPerSample: 16
-// Max Channels: 2
-// FrameSize: ((48000 * 16) / 8 / 100)) * 2
+// Max Channels: 8 (downmixed to 2, see audio_mixer.hpp)
+// FrameSize: ((48000 * 16) / 8 / 100)) * Channels
 
 #include "base_streamer.hpp"
+#include "audio_mixer.hpp"
+#include "silence_detector.hpp"
+#include "../models/media_description.hpp"
 
 namespace ntgcalls {
     class AudioStreamer final : public BaseStreamer {
         std::shared_ptr<wrtc::RTCAudioSource> audio;
-        uint8_t bps = 0, channels = 0;
+        uint8_t bps = 0, channels = 0, inputChannels = 0, packetTime = 10;
         uint32_t rate = 0;
+        AudioMixer mixer;
+        SilenceDetector silence;
 
         std::chrono::nanoseconds frameTime() override;
 
+        [[nodiscard]] int64_t chunkSize() const;
+
     public:
         AudioStreamer();
 
         ~AudioStreamer();
 
-        wrtc::MediaStreamTrack *createTrack() override;
+        wrtc::MediaStreamTrack *createTrack(const rtc::scoped_refptr<wrtc::PeerConnectionFactory>& factory) override;
 
         void sendData(const wrtc::binary& sample) override;
 
         int64_t frameSize() override;
 
-        void setConfig(uint32_t sampleRate, uint8_t bitsPerSample, uint8_t channelCount);
+        // Throws InvalidParams for anything setConfig cannot apply, so callers can check before touching any state
+        static void checkConfig(const AudioDescription& config);
+
+        void setConfig(const AudioDescription& config);
+
+        [[nodiscard]] double silenceRatio() const;
     };
 }
@@ -0,0 +1,36 @@
+//
+// Created by Laky64 on 18/10/2026.
+//
+
+#include "av_sync.hpp"
+
+#include <algorithm>
+
+namespace ntgcalls {
+    void AVSync::setTolerance(const std::chrono::milliseconds syncTolerance) {
+        tolerance = syncTolerance;
+        reset();
+    }
+
+    AVSync::Action AVSync::check(const std::chrono::nanoseconds masterTime, const std::chrono::nanoseconds slaveTime, const std::chrono::nanoseconds frameTime) {
+        const auto offset = slaveTime - masterTime;
+        offsetUs = std::chrono::duration_cast<std::chrono::microseconds>(offset).count();
+        // The slave moves one frame at a time, anything tighter would drop and repeat endlessly
+        const auto maxOffset = std::max(tolerance, frameTime);
+        if (offset < -maxOffset) {
+            return Action::Drop;
+        }
+        if (offset > maxOffset) {
+            return Action::Repeat;
+        }
+        return Action::Send;
+    }
+
+    std::chrono::microseconds AVSync::offset() const {
+        return std::chrono::microseconds(offsetUs.load());
+    }
+
+    void AVSync::reset() {
+        offsetUs = 0;
+    }
+} // ntgcalls
@@ -0,0 +1,32 @@
+//
+// Created by Laky64 on 18/10/2026.
+//
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+
+namespace ntgcalls {
+    // Audio is the master clock, video is slaved to it by dropping or repeating frames
+    class AVSync {
+        std::chrono::nanoseconds tolerance = std::chrono::nanoseconds::zero();
+        std::atomic<int64_t> offsetUs = 0;
+
+    public:
+        enum class Action {
+            Send,
+            Drop,
+            Repeat,
+        };
+
+        void setTolerance(std::chrono::milliseconds syncTolerance);
+
+        Action check(std::chrono::nanoseconds masterTime, std::chrono::nanoseconds slaveTime, std::chrono::nanoseconds frameTime);
+
+        // Slave minus master, positive when video is ahead of audio
+        [[nodiscard]] std::chrono::microseconds offset() const;
+
+        void reset();
+    };
+} // ntgcalls
@@ -11,7 +11,7 @@ namespace ntgcalls {
 
     void BaseStreamer::sendData(const wrtc::binary& sample) {
         lastTime = std::chrono::high_resolution_clock::now();
-        sentFrames++;
+        sentTime += frameTime();
     }
 
     uint64_t BaseStreamer::time() {
@@ -19,14 +19,22 @@ namespace ntgcalls {
     }
 
     std::chrono::nanoseconds BaseStreamer::nanoTime() {
-        return sentFrames * frameTime();
+        return sentTime;
     }
 
     std::chrono::nanoseconds BaseStreamer::waitTime() {
         return lastTime - std::chrono::high_resolution_clock::now() + frameTime();
     }
 
+    void BaseStreamer::setEpoch(const std::chrono::microseconds startTime) {
+        epoch = startTime;
+    }
+
+    std::chrono::microseconds BaseStreamer::captureTime() {
+        return epoch + std::chrono::duration_cast<std::chrono::microseconds>(nanoTime());
+    }
+
     void BaseStreamer::clear() {
-        sentFrames = 0;
+        sentTime = std::chrono::nanoseconds::zero();
     }
 }
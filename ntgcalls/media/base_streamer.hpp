@@ -9,8 +9,10 @@
 
 namespace ntgcalls {
     class BaseStreamer {
-        uint64_t sentFrames = 0;
+        // Sum of the frame times of every sent frame, frames do not need to share the same duration
+        std::chrono::nanoseconds sentTime = std::chrono::nanoseconds::zero();
         std::chrono::time_point<std::chrono::high_resolution_clock> lastTime;
+        std::chrono::microseconds epoch = std::chrono::microseconds::zero();
 
     protected:
         ~BaseStreamer();
@@ -19,6 +21,9 @@ namespace ntgcalls {
 
         void clear();
 
+        // Capture time of the next frame on the media clock, the time already sent from the shared epoch
+        std::chrono::microseconds captureTime();
+
     public:
         uint64_t time();
 
@@ -26,7 +31,9 @@ namespace ntgcalls {
 
         std::chrono::nanoseconds waitTime();
 
-        virtual wrtc::MediaStreamTrack *createTrack() = 0;
+        void setEpoch(std::chrono::microseconds startTime);
+
+        virtual wrtc::MediaStreamTrack *createTrack(const rtc::scoped_refptr<wrtc::PeerConnectionFactory>& factory) = 0;
 
         virtual void sendData(const wrtc::binary& sample);
 
@@ -0,0 +1,55 @@
+//
+// Created by Laky64 on 18/10/2026.
+//
+
+#include "silence_detector.hpp"
+
+#include <algorithm>
+
+namespace ntgcalls {
+    int32_t SilenceDetector::peak(const int16_t* samples, const size_t count) {
+        // Branchless on purpose, so that the compiler can vectorize it
+        int32_t res = 0;
+        for (size_t i = 0; i < count; i++) {
+            const int32_t s = samples[i];
+            res = std::max(res, s < 0 ? -s : s);
+        }
+        return res;
+    }
+
+    void SilenceDetector::setWindow(const std::chrono::milliseconds silenceWindow) {
+        window = silenceWindow;
+        reset();
+    }
+
+    bool SilenceDetector::process(const wrtc::binary& sample, const int64_t size, const std::chrono::nanoseconds frameTime) {
+        totalFrames++;
+        if (peak(reinterpret_cast<const int16_t*>(sample.get()), size / sizeof(int16_t)) >= threshold) {
+            silentTime = std::chrono::nanoseconds::zero();
+            return true;
+        }
+        silentFrames++;
+        if (window == std::chrono::nanoseconds::zero()) {
+            return true;
+        }
+        if (silentTime < window) {
+            silentTime += frameTime;
+            return true;
+        }
+        return false;
+    }
+
+    double SilenceDetector::ratio() const {
+        const auto total = totalFrames.load();
+        if (!total) {
+            return 0;
+        }
+        return static_cast<double>(silentFrames.load()) / static_cast<double>(total);
+    }
+
+    void SilenceDetector::reset() {
+        silentTime = std::chrono::nanoseconds::zero();
+        totalFrames = 0;
+        silentFrames = 0;
+    }
+} // ntgcalls
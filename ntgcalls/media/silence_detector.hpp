@@ -0,0 +1,33 @@
+//
+// Created by Laky64 on 18/10/2026.
+//
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <wrtc/wrtc.hpp>
+
+namespace ntgcalls {
+    class SilenceDetector {
+        // Peak amplitude (PCM16) under which a frame is considered silent, roughly -54 dBFS
+        static constexpr int32_t threshold = 64;
+
+        std::chrono::nanoseconds window = std::chrono::nanoseconds::zero();
+        std::chrono::nanoseconds silentTime = std::chrono::nanoseconds::zero();
+        // Read by getStats from other threads
+        std::atomic<uint64_t> totalFrames = 0, silentFrames = 0;
+
+        static int32_t peak(const int16_t* samples, size_t count);
+
+    public:
+        void setWindow(std::chrono::milliseconds silenceWindow);
+
+        bool process(const wrtc::binary& sample, int64_t size, std::chrono::nanoseconds frameTime);
+
+        [[nodiscard]] double ratio() const;
+
+        void reset();
+    };
+} // ntgcalls
@@ -0,0 +1,57 @@
+//
+// Created by Laky64 on 18/10/2026.
+//
+
+#include "static_frame_detector.hpp"
+
+#include <algorithm>
+
+namespace ntgcalls {
+    bool StaticFrameDetector::changed(const uint8_t* a, const uint8_t* b, const size_t size) {
+        for (size_t offset = 0; offset < size; offset += blockSize) {
+            const size_t count = std::min(blockSize, size - offset);
+            uint32_t sad = 0;
+            for (size_t i = 0; i < count; i++) {
+                const int32_t d = static_cast<int32_t>(a[offset + i]) - static_cast<int32_t>(b[offset + i]);
+                sad += static_cast<uint32_t>(d < 0 ? -d : d);
+            }
+            if (sad > count * tolerance) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void StaticFrameDetector::setRefresh(const std::chrono::milliseconds refreshInterval) {
+        refresh = refreshInterval;
+        reset();
+    }
+
+    bool StaticFrameDetector::process(const wrtc::binary& sample, const int64_t size, const std::chrono::nanoseconds frameTime) {
+        if (refresh == std::chrono::nanoseconds::zero()) {
+            return true;
+        }
+        if (!reference || changed(reference.get(), sample.get(), size)) {
+            reference = sample;
+            staticTime = std::chrono::nanoseconds::zero();
+            return true;
+        }
+        staticTime += frameTime;
+        if (staticTime >= refresh) {
+            staticTime = std::chrono::nanoseconds::zero();
+            return true;
+        }
+        skippedFrames++;
+        return false;
+    }
+
+    uint64_t StaticFrameDetector::skipped() const {
+        return skippedFrames;
+    }
+
+    void StaticFrameDetector::reset() {
+        reference = nullptr;
+        staticTime = std::chrono::nanoseconds::zero();
+        skippedFrames = 0;
+    }
+} // ntgcalls
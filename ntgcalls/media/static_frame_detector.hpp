@@ -0,0 +1,37 @@
+//
+// Created by Laky64 on 18/10/2026.
+//
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <wrtc/wrtc.hpp>
+
+namespace ntgcalls {
+    class StaticFrameDetector {
+        // Bytes compared at once, a block changes when its mean absolute difference goes above tolerance
+        static constexpr size_t blockSize = 64;
+        // Absorbs the ±1 dithering noise left by decoders and scalers on otherwise static content
+        static constexpr uint32_t tolerance = 1;
+
+        // Last frame that was actually pushed, unchanged frames are compared against it so slow drifts are not lost
+        wrtc::binary reference;
+        std::chrono::nanoseconds refresh = std::chrono::nanoseconds::zero();
+        std::chrono::nanoseconds staticTime = std::chrono::nanoseconds::zero();
+        // Read by getStats from other threads
+        std::atomic<uint64_t> skippedFrames = 0;
+
+        static bool changed(const uint8_t* a, const uint8_t* b, size_t size);
+
+    public:
+        void setRefresh(std::chrono::milliseconds refreshInterval);
+
+        bool process(const wrtc::binary& sample, int64_t size, std::chrono::nanoseconds frameTime);
+
+        [[nodiscard]] uint64_t skipped() const;
+
+        void reset();
+    };
+} // ntgcalls
@@ -4,6 +4,11 @@
 
 #include "video_streamer.hpp"
 
+#include <algorithm>
+#include <cmath>
+
+#include "../exceptions.hpp"
+
 namespace ntgcalls {
     VideoStreamer::VideoStreamer() {
         video = std::make_shared<wrtc::RTCVideoSource>();
@@ -13,37 +18,192 @@ namespace ntgcalls {
         fps = 0;
         w = 0;
         h = 0;
+        lastSample = nullptr;
+        pendingSample = nullptr;
         video = nullptr;
     }
 
     std::chrono::nanoseconds VideoStreamer::frameTime() {
+        if (timestamped && frameDuration) {
+            return *frameDuration;
+        }
         return std::chrono::microseconds(static_cast<uint64_t>(1000.0 * 1000.0 / static_cast<double_t>(fps))); // ms
     }
 
-    wrtc::MediaStreamTrack *VideoStreamer::createTrack() {
-        return video->createTrack();
+    wrtc::MediaStreamTrack *VideoStreamer::createTrack(const rtc::scoped_refptr<wrtc::PeerConnectionFactory>& factory) {
+        return video->createTrack(factory);
+    }
+
+    void VideoStreamer::updateScaling(const std::chrono::nanoseconds lateness) {
+        constexpr uint8_t maxSteps = 4;
+        constexpr uint32_t stepDownAfter = 10;
+        const auto previousStep = scaleStep;
+        if (lateness > frameTime() / 2) {
+            onTimeFrames = 0;
+            if (++lateFrames >= stepDownAfter && scaleStep < maxSteps) {
+                lateFrames = 0;
+                scaleStep++;
+            }
+        } else {
+            lateFrames = 0;
+            // Wait for about 10 seconds of headroom before stepping back up
+            if (scaleStep && ++onTimeFrames >= static_cast<uint32_t>(fps) * 10) {
+                onTimeFrames = 0;
+                scaleStep--;
+            }
+        }
+        if (previousStep != scaleStep) {
+            std::optional<int> maxPixelCount;
+            if (scaleStep) {
+                maxPixelCount = static_cast<int>(w * h * std::pow(0.75, scaleStep));
+            }
+            video->setMaxPixelCount(maxPixelCount);
+        }
     }
 
     void VideoStreamer::sendData(const wrtc::binary& sample) {
+        consumedFrames++;
+        if (!timestamped) {
+            pushFrame(sample);
+            return;
+        }
+        const auto previousPts = pendingPts;
+        const auto previous = std::exchange(pendingSample, nullptr);
+        queueFrame(sample);
+        if (previous) {
+            // Long gaps would hold the stream lock for as long, pause and stop must stay responsive
+            frameDuration = std::clamp<std::chrono::nanoseconds>(pendingPts - previousPts, std::chrono::nanoseconds::zero(), std::chrono::seconds(1));
+            pushFrame(previous);
+        }
+    }
+
+    void VideoStreamer::queueFrame(const wrtc::binary& sample) {
+        if (!sample) {
+            return;
+        }
+        uint64_t pts = 0;
+        for (int i = sizeof(pts) - 1; i >= 0; i--) {
+            pts = pts << 8 | sample[i];
+        }
+        const auto presentationTime = std::chrono::microseconds(static_cast<int64_t>(pts));
+        if (!firstPts) {
+            firstPts = presentationTime;
+        }
+        pendingPts = presentationTime - *firstPts;
+        // Shares ownership with the read buffer, only the header is skipped
+        pendingSample = wrtc::binary(sample, sample.get() + sizeof(pts));
+    }
+
+    std::chrono::nanoseconds VideoStreamer::mediaTime() {
+        if (timestamped) {
+            return pendingPts;
+        }
+        return consumedFrames * frameTime();
+    }
+
+    void VideoStreamer::pushFrame(const wrtc::binary& sample) {
+        const auto timestamp = captureTime();
+        if (adaptive) {
+            updateScaling(-waitTime());
+        }
         BaseStreamer::sendData(sample);
+        lastSample = sample;
+        if (!sample || !staticFrames.process(sample, imageSize(), frameTime())) {
+            return;
+        }
         video->OnFrame(
-            wrtc::i420ImageData(
+            wrtc::RawImageData(
                 w,
                 h,
+                format,
                 sample
-            )
+            ),
+            timestamp
         );
     }
 
+    AVSync::Action VideoStreamer::syncTo(const std::chrono::nanoseconds audioTime) {
+        return sync.check(audioTime, mediaTime(), frameTime());
+    }
+
+    void VideoStreamer::repeatFrame() {
+        // Keeps the sent frame count in step with audio even when there is nothing to show yet
+        pushFrame(lastSample);
+    }
+
+    void VideoStreamer::flush() {
+        if (const auto last = std::exchange(pendingSample, nullptr)) {
+            // Nothing follows, the last frame keeps the duration of the previous one
+            pushFrame(last);
+        }
+    }
+
+    void VideoStreamer::dropFrame(const wrtc::binary& sample) {
+        consumedFrames++;
+        if (timestamped) {
+            queueFrame(sample);
+        }
+    }
+
+    std::chrono::microseconds VideoStreamer::avOffset() const {
+        return sync.offset();
+    }
+
     int64_t VideoStreamer::frameSize() {
-        return llround(static_cast<float>(w * h) * 1.5f);
+        return imageSize() + (timestamped ? sizeof(uint64_t) : 0);
     }
 
-    void VideoStreamer::setConfig(const uint16_t width, const uint16_t height, const uint8_t framesPerSecond) {
+    int64_t VideoStreamer::imageSize() const {
+        return wrtc::RawImageData::frameSize(format, w, h);
+    }
+
+    void VideoStreamer::checkConfig(const VideoDescription& config) {
+        if (config.codecs.empty()) {
+            throw InvalidParams("At least one video codec is required");
+        }
+        for (auto it = config.codecs.begin(); it != config.codecs.end(); ++it) {
+            if (std::find(config.codecs.begin(), it, *it) != it) {
+                throw InvalidParams("Video codecs must not be repeated");
+            }
+        }
+        if (config.encoding) {
+            if (config.encoding->simulcastLayers > 3) {
+                throw InvalidParams("Simulcast supports up to 3 layers");
+            }
+            if (config.encoding->temporalLayers > 3) {
+                throw InvalidParams("Temporal layers must be at most 3, 0 or 1 disables them");
+            }
+            if (config.encoding->minBitrate && config.encoding->maxBitrate && config.encoding->minBitrate > config.encoding->maxBitrate) {
+                throw InvalidParams("Video minimum bitrate must not exceed the maximum one");
+            }
+        }
+    }
+
+    void VideoStreamer::setConfig(const VideoDescription& config) {
         clear();
-        w = width;
-        h = height;
-        fps = framesPerSecond;
+        w = config.width;
+        h = config.height;
+        fps = config.fps;
+        format = config.pixelFormat;
+        adaptive = config.adaptiveScaling;
+        scaleStep = 0;
+        lateFrames = 0;
+        onTimeFrames = 0;
+        video->setAdaptation(adaptive);
+        video->setMaxPixelCount(std::nullopt);
+        staticFrames.setRefresh(std::chrono::milliseconds(config.staticRefresh));
+        sync.setTolerance(std::chrono::milliseconds(config.syncTolerance));
+        consumedFrames = 0;
+        lastSample = nullptr;
+        timestamped = config.timestamped;
+        pendingSample = nullptr;
+        firstPts = std::nullopt;
+        pendingPts = std::chrono::microseconds::zero();
+        frameDuration = std::nullopt;
+    }
+
+    uint64_t VideoStreamer::skippedFrames() const {
+        return staticFrames.skipped();
     }
 }
 
@@ -4,37 +4,88 @@
 
 #pragma once
 
-// i420 VIDEO CODEC SPECIFICATION
+// RAW VIDEO CODEC SPECIFICATION
 // Frame Time: 1000 / FPS ms
 // Max FPS: 60
 // Max Height: 1280
 // Max Width: 1280
-// FrameSize: A YUV frame size for a Width * Height resolution image,
+// Pixel Formats: I420 (default), NV12, RGB24, RGBA, BGRA, YUYV, UYVY
+// FrameSize: For I420 and NV12 a YUV frame size for a Width * Height resolution image,
 // where Y (luminance) and UV (chrominance) components are combined with a 3:2 pixel ratio.
+// Packed formats take Width * Height * BytesPerPixel, they are converted to I420 before encoding.
+// Adaptive Scaling: Each step lowers the pixel count to 3/4, up to 4 steps
+// Static Frames: Unchanged frames are pushed once every staticRefresh ms instead of every frame time
+// Sync: When audio is playing, video frames are dropped or repeated to stay within syncTolerance ms of it
+// Timestamped: Each frame is preceded by its presentation time in µs as a little-endian int64,
+// frames are paced by it and FPS is only used as the nominal rate. Gaps above 1 second are shortened,
+// repeated or decreasing timestamps are pushed right away.
 
 
 #include "base_streamer.hpp"
+#include "av_sync.hpp"
+#include "static_frame_detector.hpp"
+#include "../models/media_description.hpp"
 
 namespace ntgcalls {
     class VideoStreamer final : public BaseStreamer {
         std::shared_ptr<wrtc::RTCVideoSource> video;
         uint16_t w = 0, h = 0;
         uint8_t fps = 0;
+        wrtc::PixelFormat format = wrtc::PixelFormat::I420;
+        bool adaptive = false;
+        uint8_t scaleStep = 0;
+        uint32_t lateFrames = 0, onTimeFrames = 0;
+        StaticFrameDetector staticFrames;
+        AVSync sync;
+        // Frames read from the input, unlike sent frames these also count drops and exclude repeats
+        uint64_t consumedFrames = 0;
+        wrtc::binary lastSample;
+        bool timestamped = false;
+        // The duration of a timestamped frame is only known once the next one is read
+        wrtc::binary pendingSample;
+        std::optional<std::chrono::microseconds> firstPts;
+        std::chrono::microseconds pendingPts = std::chrono::microseconds::zero();
+        // Unset until two frames were read, a zero duration is valid for frames sharing the same PTS
+        std::optional<std::chrono::nanoseconds> frameDuration;
 
         std::chrono::nanoseconds frameTime() override;
 
+        [[nodiscard]] int64_t imageSize() const;
+
+        [[nodiscard]] std::chrono::nanoseconds mediaTime();
+
+        void queueFrame(const wrtc::binary& sample);
+
+        void updateScaling(std::chrono::nanoseconds lateness);
+
+        void pushFrame(const wrtc::binary& sample);
+
     public:
         VideoStreamer();
 
         ~VideoStreamer();
 
-        wrtc::MediaStreamTrack *createTrack() override;
+        wrtc::MediaStreamTrack *createTrack(const rtc::scoped_refptr<wrtc::PeerConnectionFactory>& factory) override;
 
         void sendData(const wrtc::binary& sample) override;
 
         int64_t frameSize() override;
 
-        void setConfig(uint16_t width, uint16_t height, uint8_t framesPerSecond);
+        static void checkConfig(const VideoDescription& config);
+
+        void setConfig(const VideoDescription& config);
+
+        [[nodiscard]] uint64_t skippedFrames() const;
+
+        AVSync::Action syncTo(std::chrono::nanoseconds audioTime);
+
+        void repeatFrame();
+
+        // Pushes the timestamped frame still waiting for its successor, called once the input ended
+        void flush();
+
+        void dropFrame(const wrtc::binary& sample);
+
+        [[nodiscard]] std::chrono::microseconds avOffset() const;
     };
 }
-
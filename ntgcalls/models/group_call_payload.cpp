@@ -6,16 +6,14 @@
 
 namespace ntgcalls {
     GroupCallPayload::GroupCallPayload(wrtc::Description &desc) {
-        const auto [fingerprint, hash, setup, pwd, ufrag, audioSource, source_groups] = wrtc::SdpBuilder::parseSdp(desc.getSdp());
+        const auto [fingerprint, hash, setup, pwd, ufrag, audioSource, ssrc_groups] = wrtc::SdpBuilder::parseSdp(desc.getSdp());
         this->ufrag = ufrag;
         this->pwd = pwd;
         this->fingerprint = fingerprint;
         this->hash = hash;
         this->setup = setup;
         this->audioSource = static_cast<wrtc::TgSSRC>(audioSource);
-        for (auto &ssrc : source_groups) {
-            this->sourceGroups.push_back(static_cast<wrtc::TgSSRC>(ssrc));
-        }
+        this->ssrcGroups = ssrc_groups;
     }
 
     GroupCallPayload::operator std::string() const {
@@ -31,13 +29,19 @@ namespace ntgcalls {
             }},
             {"ssrc", audioSource},
         };
-        if (!sourceGroups.empty()){
-            jsonRes["ssrc-groups"] = {
-                {
-                    {"semantics", "FID"},
-                    {"sources", sourceGroups}
+        if (!ssrcGroups.empty()){
+            // SIM lists one primary SSRC per simulcast layer, each FID pairs a primary with its RTX
+            jsonRes["ssrc-groups"] = json::array();
+            for (const auto& [semantics, ssrcs] : ssrcGroups) {
+                std::vector<wrtc::TgSSRC> sources;
+                for (const auto& ssrc : ssrcs) {
+                    sources.push_back(static_cast<wrtc::TgSSRC>(ssrc));
                 }
-            };
+                jsonRes["ssrc-groups"].push_back({
+                    {"semantics", semantics},
+                    {"sources", sources}
+                });
+            }
         }
         return to_string(jsonRes);
     }
@@ -19,7 +19,7 @@ namespace ntgcalls {
         std::string setup;
         std::string fingerprint;
         wrtc::TgSSRC audioSource;
-        std::vector<wrtc::TgSSRC> sourceGroups;
+        std::vector<wrtc::SsrcGroup> ssrcGroups;
 
         explicit GroupCallPayload(wrtc::Description &desc);
 
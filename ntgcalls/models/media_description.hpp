@@ -4,9 +4,12 @@
 
 #pragma once
 
+#include <cstdint>
 #include <optional>
 #include <string>
 #include <utility>
+#include <vector>
+#include <wrtc/enums.hpp>
 
 namespace ntgcalls {
     class BaseMediaDescription {
@@ -23,10 +26,52 @@ namespace ntgcalls {
         BaseMediaDescription(std::string  input, const InputMode inputMode): input(std::move(input)), inputMode(inputMode) {}
     };
 
+    class AudioEncoding {
+    public:
+        // Target bitrate in bps, 0 lets the encoder decide
+        uint32_t bitrate = 0;
+        // Opus complexity between 0 and 10, -1 keeps the WebRTC default
+        int8_t complexity = -1;
+        bool stereo = false;
+        bool fec = true;
+        // Packet time in ms, one of 10, 20, 40 or 60
+        uint8_t packetTime = 10;
+        // Send bitrate bounds in bps, 0 leaves them to bandwidth estimation
+        uint32_t minBitrate = 0;
+        uint32_t maxBitrate = 0;
+    };
+
+    class VideoEncoding {
+    public:
+        // Encoder threads, 0 lets the encoder decide from the available cores
+        uint8_t threads = 0;
+        // Quality trades encoder CPU for picture quality, Default keeps the realtime speed of the encoders
+        wrtc::EncoderPreset preset = wrtc::EncoderPreset::Default;
+        wrtc::ContentHint contentHint = wrtc::ContentHint::Generic;
+        // Auto follows the content hint, detail and text keep the resolution
+        wrtc::DegradationPreference degradation = wrtc::DegradationPreference::Auto;
+        // Simulcast layers (up to 3), each one adds an SSRC to the join payload, 0 or 1 to disable
+        uint8_t simulcastLayers = 1;
+        // Temporal layers per encoding (L1T2, L1T3), 0 or 1 to disable
+        uint8_t temporalLayers = 1;
+        // Bitrates in bps, the start one is negotiated once when the call is connected, 0 keeps the defaults
+        uint32_t startBitrate = 0;
+        uint32_t minBitrate = 0;
+        uint32_t maxBitrate = 0;
+    };
+
     class AudioDescription: public BaseMediaDescription {
     public:
         uint32_t sampleRate;
         uint8_t bitsPerSample, channelCount;
+        // Milliseconds of continuous silence after which frames are no longer pushed, 0 to disable
+        uint16_t silenceWindow = 0;
+        // Unset to use the defaults of the factory audio profile
+        std::optional<AudioEncoding> encoding;
+        // Samples are grouped by channel instead of interleaved
+        bool planar = false;
+        // Channels sent to WebRTC (1 or 2), 0 keeps channelCount and downmixes anything above 2 to stereo
+        uint8_t downmixChannels = 0;
 
         AudioDescription(const InputMode inputMode, const uint32_t sampleRate, const uint8_t bitsPerSample, const uint8_t channelCount, const std::string& input):
                 BaseMediaDescription(input, inputMode), sampleRate(sampleRate), bitsPerSample(bitsPerSample), channelCount(channelCount) {};
@@ -36,6 +81,20 @@ namespace ntgcalls {
     public:
         uint16_t width, height;
         uint8_t fps;
+        wrtc::PixelFormat pixelFormat = wrtc::PixelFormat::I420;
+        // Lets the encoder overuse detector and missed pacing deadlines lower the sent resolution
+        bool adaptiveScaling = false;
+        // Milliseconds between pushes of an unchanged frame, 0 to disable static frame detection
+        uint16_t staticRefresh = 0;
+        // Maximum distance in ms from the audio clock before frames are dropped or repeated, never below one frame time
+        uint16_t syncTolerance = 0;
+        std::optional<VideoEncoding> encoding;
+        // Milliseconds between forced keyframes, 0 leaves them to the encoder and to receiver requests
+        uint16_t keyframeInterval = 0;
+        // Frames carry their presentation time and are paced by it, see video_streamer.hpp
+        bool timestamped = false;
+        // Codecs in order of preference, negotiated once when the call is connected
+        std::vector<wrtc::VideoCodec> codecs = {wrtc::VideoCodec::VP8, wrtc::VideoCodec::VP9};
 
         VideoDescription(const InputMode inputMode, const uint16_t width, const uint16_t height, const uint8_t fps, const std::string& input):
                 BaseMediaDescription(input, inputMode), width(width), height(height), fps(fps) {}
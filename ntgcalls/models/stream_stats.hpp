@@ -0,0 +1,18 @@
+//
+// Created by Laky64 on 18/10/2026.
+//
+
+#pragma once
+
+#include <cstdint>
+
+namespace ntgcalls {
+
+    struct StreamStats {
+        double silenceRatio;
+        uint64_t skippedFrames;
+        // Video minus audio position in ms, positive when video is ahead
+        double avOffset;
+    };
+
+} // ntgcalls
@@ -0,0 +1,20 @@
+//
+// Created by Laky64 on 18/10/2026.
+//
+
+#pragma once
+
+#include <cstdint>
+
+namespace ntgcalls {
+
+    struct WarmPoolStats {
+        // Connections the pool keeps ready
+        uint32_t size;
+        uint32_t ready;
+        // Calls created from a warm connection and calls that had to create their own
+        uint64_t hits;
+        uint64_t misses;
+    };
+
+} // ntgcalls
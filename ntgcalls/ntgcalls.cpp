@@ -7,33 +7,76 @@
 #include "exceptions.hpp"
 
 namespace ntgcalls {
-    std::string NTgCalls::createCall(int64_t chatId, const MediaDescription& media) {
-        if (exists(chatId)) {
+    std::string NTgCalls::createCall(const int64_t chatId, const MediaDescription& media) {
+        const auto client = addConnection(chatId, media);
+        try {
+            return client->init(media);
+        } catch (...) {
+            removeConnection(chatId, client.get());
+            throw;
+        }
+    }
+
+    void NTgCalls::createCallAsync(
+        const int64_t chatId,
+        const MediaDescription& media,
+        const std::function<void(const std::string&)>& onSuccess,
+        const std::function<void(const std::exception_ptr&)>& onFailed
+    ) {
+        const auto client = addConnection(chatId, media);
+        try {
+            client->init(media, onSuccess, [this, chatId, client = client.get(), onFailed](const std::exception_ptr& exc) {
+                removeConnection(chatId, client);
+                onFailed(exc);
+            });
+        } catch (...) {
+            removeConnection(chatId, client.get());
+            throw;
+        }
+    }
+
+    void NTgCalls::removeConnection(const int64_t chatId, const Client* client) {
+        // A failed init leaves nothing to stop later, the chat can be joined again right away
+        connections.remove(chatId, client);
+    }
+
+    std::shared_ptr<Client> NTgCalls::addConnection(const int64_t chatId, const MediaDescription& media) {
+        const auto client = connections.add(chatId, *warmPool, Client::simulcastLayers(media));
+        if (!client) {
             throw ConnectionError("Connection cannot be initialized more than once.");
         }
-        connections[chatId] = std::make_shared<Client>();
-        connections[chatId]->onStreamEnd([this, chatId](const Stream::Type type) {
+        client->onStreamEnd([this, chatId](const Stream::Type type) {
             (void) onEof(chatId, type);
         });
-        connections[chatId]->onUpgrade([this, chatId](const MediaState state) {
+        client->onUpgrade([this, chatId](const MediaState state) {
             (void) onChangeStatus(chatId, state);
         });
-        return connections[chatId]->init(media);
+        client->onReconnect([this, chatId](const std::string& params) {
+            (void) onReconnectNeeded(chatId, params);
+        });
+        return client;
     }
 
     NTgCalls::~NTgCalls() {
-        // Temporary fix because macOs sucks and currently doesnt support Elements View
-        // ReSharper disable once CppUseElementsView
-        for (const auto& [fst, snd] : connections) {
-            snd->stop();
+        warmPool->clear();
+        for (const auto& client : connections.clear()) {
+            client->stop();
         }
-        connections = {};
     }
 
     void NTgCalls::connect(const int64_t chatId, const std::string& params) {
         safeConnection(chatId)->connect(params);
     }
 
+    void NTgCalls::connectAsync(
+        const int64_t chatId,
+        const std::string& params,
+        const std::function<void()>& onConnected,
+        const std::function<void(const std::exception_ptr&)>& onFailed
+    ) {
+        safeConnection(chatId)->connect(params, onConnected, onFailed);
+    }
+
     void NTgCalls::changeStream(const int64_t chatId, const MediaDescription& media) {
         safeConnection(chatId)->changeStream(media);
     }
@@ -46,6 +89,10 @@ namespace ntgcalls {
         return safeConnection(chatId)->resume();
     }
 
+    bool NTgCalls::requestKeyframe(const int64_t chatId) {
+        return safeConnection(chatId)->requestKeyframe();
+    }
+
     bool NTgCalls::mute(const int64_t chatId) {
         return safeConnection(chatId)->mute();
     }
@@ -55,8 +102,11 @@ namespace ntgcalls {
     }
 
     void NTgCalls::stop(const int64_t chatId) {
-        safeConnection(chatId)->stop();
-        connections.erase(connections.find(chatId));
+        const auto client = connections.erase(chatId);
+        if (!client) {
+            throw ConnectionNotFound("Connection with chat id \"" + std::to_string(chatId) + "\" not found");
+        }
+        client->stop();
     }
 
     void NTgCalls::onStreamEnd(const std::function<void(int64_t, Stream::Type)>& callback) {
@@ -67,6 +117,10 @@ namespace ntgcalls {
         onChangeStatus = callback;
     }
 
+    void NTgCalls::onReconnect(const std::function<void(int64_t, const std::string&)>& callback) {
+        onReconnectNeeded = callback;
+    }
+
     uint64_t NTgCalls::time(const int64_t chatId) {
         return safeConnection(chatId)->time();
     }
@@ -75,21 +129,26 @@ namespace ntgcalls {
         return safeConnection(chatId)->getState();
     }
 
+    StreamStats NTgCalls::getStats(const int64_t chatId) {
+        return safeConnection(chatId)->getStats();
+    }
+
     bool NTgCalls::exists(const int64_t chatId) const
     {
         return connections.contains(chatId);
     }
 
     std::shared_ptr<Client> NTgCalls::safeConnection(const int64_t chatId) {
-        if (!exists(chatId)) {
+        auto client = connections.find(chatId);
+        if (!client) {
             throw ConnectionNotFound("Connection with chat id \"" + std::to_string(chatId) + "\" not found");
         }
-        return connections[chatId];
+        return client;
     }
 
     std::map<int64_t, Stream::Status> NTgCalls::calls() const {
         std::map<int64_t, Stream::Status> statusList;
-        for (const auto& [fst, snd] : connections) {
+        for (const auto& [fst, snd] : connections.snapshot()) {
             statusList[fst] = snd->status();
         }
         return statusList;
@@ -98,4 +157,18 @@ namespace ntgcalls {
     std::string NTgCalls::ping() {
         return "pong";
     }
+
+    void NTgCalls::setFactoryConfig(const wrtc::FactoryConfig& config) {
+        if (!wrtc::PeerConnectionFactory::SetConfig(config)) {
+            throw ConnectionError("Factory config can't change while calls or warm connections are alive");
+        }
+    }
+
+    void NTgCalls::setWarmPoolSize(const uint32_t size) {
+        warmPool->setSize(size);
+    }
+
+    WarmPoolStats NTgCalls::getWarmPoolStats() {
+        return warmPool->stats();
+    }
 } // ntgcalls
\ No newline at end of file
@@ -7,31 +7,57 @@
 #include <cstdint>
 #include "client.hpp"
 #include "models/media_description.hpp"
+#include "warm_pool.hpp"
+#include "utils/call_registry.hpp"
 
 namespace ntgcalls {
 
     class NTgCalls {
-        std::map<int64_t, std::shared_ptr<Client>> connections;
+        std::shared_ptr<WarmPool> warmPool = std::make_shared<WarmPool>();
         wrtc::synchronized_callback<int64_t, Stream::Type> onEof;
         wrtc::synchronized_callback<int64_t, MediaState> onChangeStatus;
+        wrtc::synchronized_callback<int64_t, std::string> onReconnectNeeded;
+        // Declared last, its cleanup queue still runs client callbacks that use the members above
+        CallRegistry<Client, WarmPool> connections;
 
         bool exists(int64_t chatId) const;
 
         std::shared_ptr<Client> safeConnection(int64_t chatId);
 
+        std::shared_ptr<Client> addConnection(int64_t chatId, const MediaDescription& media);
+
+        void removeConnection(int64_t chatId, const Client* client);
+
     public:
         ~NTgCalls();
 
         std::string createCall(int64_t chatId, const MediaDescription& media);
 
+        // Errors before signaling starts are thrown, later ones are passed to onFailed on the signaling thread
+        void createCallAsync(
+            int64_t chatId,
+            const MediaDescription& media,
+            const std::function<void(const std::string&)>& onSuccess,
+            const std::function<void(const std::exception_ptr&)>& onFailed
+        );
+
         void connect(int64_t chatId, const std::string& params);
 
+        void connectAsync(
+            int64_t chatId,
+            const std::string& params,
+            const std::function<void()>& onConnected,
+            const std::function<void(const std::exception_ptr&)>& onFailed
+        );
+
         void changeStream(int64_t chatId, const MediaDescription& media);
 
         bool pause(int64_t chatId);
 
         bool resume(int64_t chatId);
 
+        bool requestKeyframe(int64_t chatId);
+
         bool mute(int64_t chatId);
 
         bool unmute(int64_t chatId);
@@ -42,12 +68,24 @@ namespace ntgcalls {
 
         MediaState getState(int64_t chatId);
 
+        StreamStats getStats(int64_t chatId);
+
         static std::string ping();
 
+        static void setFactoryConfig(const wrtc::FactoryConfig& config);
+
+        // Keeps up to size connections with their offer already created, 0 disables the pool
+        void setWarmPoolSize(uint32_t size);
+
+        WarmPoolStats getWarmPoolStats();
+
         void onUpgrade(const std::function<void(int64_t, MediaState)>& callback);
 
         void onStreamEnd(const std::function<void(int64_t, Stream::Type)>& callback);
 
+        // New join params for a call whose transport was lost, rejoin with them and pass the result to connect
+        void onReconnect(const std::function<void(int64_t, const std::string&)>& callback);
+
         std::map<int64_t, Stream::Status> calls() const;
     };
 
@@ -5,6 +5,8 @@
 // ReSharper disable CppDFAUnreachableFunctionCall
 #include "stream.hpp"
 
+#include "utils/uplink_budget.hpp"
+
 namespace ntgcalls {
     Stream::Stream() {
         audio = std::make_shared<AudioStreamer>();
@@ -24,13 +26,14 @@ namespace ntgcalls {
     }
 
     void Stream::addTracks(const std::shared_ptr<wrtc::PeerConnection>& pc) {
-        audioTrack = audio->createTrack();
-        videoTrack = video->createTrack();
+        audioTrack = audio->createTrack(pc->peerConnectionFactory());
+        videoTrack = video->createTrack(pc->peerConnectionFactory());
         pc->addTrack(audioTrack);
         pc->addTrack(videoTrack);
+        connection = pc;
     }
 
-    std::pair<std::shared_ptr<BaseStreamer>, std::shared_ptr<BaseReader>> Stream::unsafePrepareForSample() const {
+    std::pair<std::shared_ptr<BaseStreamer>, std::shared_ptr<BaseReader>> Stream::unsafePrepareForSample(std::unique_lock<std::recursive_mutex>& lock) {
         std::shared_ptr<BaseStreamer> bs;
         std::shared_ptr<BaseReader> br;
         if (reader->audio && reader->video) {
@@ -50,11 +53,43 @@ namespace ntgcalls {
         }
 
         if (const auto waitTime = bs->waitTime(); std::chrono::duration_cast<std::chrono::milliseconds>(waitTime).count() > 0) {
-            std::this_thread::sleep_for(waitTime);
+            if (const auto seen = changes; wake.wait_for(lock, waitTime, [&] { return changes != seen; })) {
+                // The streamers and the reader were swapped meanwhile, this sample belongs to the old stream
+                return {};
+            }
         }
         return {bs, br};
     }
 
+    void Stream::resetClock() const {
+        // Audio and video share the same start instant, so receivers can line them up for lip sync
+        const auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(std::max(audio->nanoTime(), video->nanoTime()));
+        const auto epoch = wrtc::mediaClock() - elapsed;
+        audio->setEpoch(epoch);
+        video->setEpoch(epoch);
+    }
+
+    void Stream::sendSyncedVideo() const {
+        // Audio is the master clock, a late video input must never hold it back
+        while (true) {
+            const auto action = video->syncTo(audio->nanoTime());
+            if (action == AVSync::Action::Repeat) {
+                video->repeatFrame();
+                return;
+            }
+            const auto sample = reader->video->read(video->frameSize(), false);
+            if (!sample) {
+                video->repeatFrame();
+                return;
+            }
+            if (action == AVSync::Action::Send) {
+                video->sendData(sample);
+                return;
+            }
+            video->dropFrame(sample);
+        }
+    }
+
     void Stream::checkStream() const {
         if (running && !changing) {
             if (reader->audio && reader->audio->eof()) {
@@ -64,6 +99,7 @@ namespace ntgcalls {
                 });
             }
             if (reader->video && reader->video->eof()) {
+                video->flush();
                 reader->video = nullptr;
                 updateQueue->dispatch([&] {
                     (void) onEOF(Video);
@@ -73,13 +109,20 @@ namespace ntgcalls {
     }
 
     void Stream::sendSample() {
-        std::lock_guard lock(mutex);
+        std::unique_lock lock(mutex);
         if (running) {
             if (idling || changing || !reader || !(reader->audio || reader->video)) {
-                std::this_thread::sleep_for(std::chrono::milliseconds(500));
+                // Waiting releases the lock, so setAVStream never waits for the idle timeout
+                const auto seen = changes;
+                wake.wait_for(lock, std::chrono::milliseconds(500), [&] { return changes != seen; });
             } else {
-                if (auto [fst, snd] = unsafePrepareForSample(); fst && snd) {
-                    if (const auto sample = snd->read(fst->frameSize())) {
+                if (auto [fst, snd] = unsafePrepareForSample(lock); fst && snd) {
+                    if (std::exchange(clockPending, false)) {
+                        resetClock();
+                    }
+                    if (fst == video && reader->audio) {
+                        sendSyncedVideo();
+                    } else if (const auto sample = snd->read(fst->frameSize())) {
                         fst->sendData(sample);
                     }
                 }
@@ -93,34 +136,104 @@ namespace ntgcalls {
         }
     }
 
+    void Stream::checkConfig(const MediaDescription& streamConfig) {
+        if (streamConfig.audio) {
+            AudioStreamer::checkConfig(streamConfig.audio.value());
+        }
+        if (streamConfig.video) {
+            VideoStreamer::checkConfig(streamConfig.video.value());
+        }
+    }
+
     void Stream::setAVStream(const MediaDescription& streamConfig, const bool noUpgrade) {
-        changing = true;
+        // Nothing below may throw once the old stream is torn down, it would stay stuck in changing
+        checkConfig(streamConfig);
+        auto newReader = std::make_shared<MediaReaderFactory>(streamConfig);
         const auto audioConfig = streamConfig.audio;
         const auto videoConfig = streamConfig.video;
-        reader = std::make_shared<MediaReaderFactory>(streamConfig);
-        idling = false;
-        if (audioConfig) {
-            audio->setConfig(
-                audioConfig->sampleRate,
-                audioConfig->bitsPerSample,
-                audioConfig->channelCount
-            );
-        }
-        const bool wasVideo = hasVideo;
-        if (videoConfig) {
-            hasVideo = true;
-            video->setConfig(
-                videoConfig->width,
-                videoConfig->height,
-                videoConfig->fps
-            );
-        } else {
-            hasVideo = false;
+        bool wasVideo;
+        {
+            // The stream thread reads the mixer, the streamers and the reader while holding it
+            std::lock_guard lock(mutex);
+            changing = true;
+            reader = std::move(newReader);
+            idling = false;
+            if (audioConfig) {
+                audio->setConfig(audioConfig.value());
+            }
+            wasVideo = hasVideo;
+            if (videoConfig) {
+                hasVideo = true;
+                video->setConfig(videoConfig.value());
+                // Threads and preset are negotiated once in the SDP, hint and degradation can change with every stream
+                const auto encoding = videoConfig->encoding.value_or(VideoEncoding());
+                videoTrack->setContentHint(encoding.contentHint);
+            } else {
+                hasVideo = false;
+            }
+            {
+                std::lock_guard bitrateLock(bitrateMutex);
+                const auto audioEncoding = audioConfig ? audioConfig->encoding.value_or(AudioEncoding()) : AudioEncoding();
+                const auto videoEncoding = videoConfig ? videoConfig->encoding.value_or(VideoEncoding()) : VideoEncoding();
+                audioMinBitrate = audioEncoding.minBitrate;
+                audioMaxBitrate = audioEncoding.maxBitrate;
+                videoMinBitrate = videoEncoding.minBitrate;
+                videoMaxBitrate = videoEncoding.maxBitrate;
+            }
+            clockPending = true;
+            changing = false;
+            changes++;
         }
-        changing = false;
-        if (wasVideo != hasVideo && !noUpgrade) {
-            checkUpgrade();
+        wake.notify_all();
+        if (wasVideo != hasVideo) {
+            if (running) {
+                UplinkBudget::update();
+            }
+            if (!noUpgrade) {
+                checkUpgrade();
+            }
+        }
+        // Sender parameters go last, a failure here must not leave the new stream half applied
+        if (const auto pc = connection.lock(); pc && videoConfig) {
+            const auto encoding = videoConfig->encoding.value_or(VideoEncoding());
+            pc->setDegradationPreference(videoTrack, encoding.degradation);
+            pc->setTemporalLayers(videoTrack, encoding.temporalLayers);
+            const auto& control = pc->encoderControl();
+            control->setKeyframeInterval(std::chrono::milliseconds(videoConfig->keyframeInterval));
+            // Receivers can decode the new source right away instead of waiting for a PLI
+            control->requestKeyframe();
+        }
+        applyBitrate();
+    }
+
+    bool Stream::sendsVideo() const {
+        return hasVideo;
+    }
+
+    void Stream::setUplinkShare(const uint32_t share) {
+        {
+            std::lock_guard lock(bitrateMutex);
+            uplinkShare = share;
+        }
+        try {
+            applyBitrate();
+        } catch (...) {
+            // The connection was closed meanwhile, nothing left to cap
+        }
+    }
+
+    void Stream::applyBitrate() {
+        std::lock_guard lock(bitrateMutex);
+        const auto pc = connection.lock();
+        if (!pc || !audioTrack || !videoTrack) {
+            return;
+        }
+        pc->setBitrateLimits(audioTrack, audioMinBitrate, audioMaxBitrate);
+        auto videoCap = videoMaxBitrate;
+        if (uplinkShare && (!videoCap || uplinkShare < videoCap)) {
+            videoCap = uplinkShare;
         }
+        pc->setBitrateLimits(videoTrack, videoMinBitrate, videoCap);
     }
 
     void Stream::checkUpgrade() const {
@@ -137,11 +250,16 @@ namespace ntgcalls {
         };
     }
 
+    StreamStats Stream::getStats() const {
+        return StreamStats{
+            audio->silenceRatio(),
+            video->skippedFrames(),
+            static_cast<double>(video->avOffset().count()) / 1000.0
+        };
+    }
+
     uint64_t Stream::time() const {
         if (reader) {
-            if (reader->audio && reader->video) {
-                return (audio->time() + video->time()) / 2;
-            }
             if (reader->audio) {
                 return audio->time();
             }
@@ -162,6 +280,7 @@ namespace ntgcalls {
     void Stream::start() {
         if (!running) {
             running = true;
+            UplinkBudget::join(weak_from_this());
             streamQueue->dispatch([this] {
                 sendSample();
             });
@@ -176,10 +295,20 @@ namespace ntgcalls {
 
     bool Stream::resume() {
         const auto res = std::exchange(idling, false);
+        // Media time stood still while paused, move the epoch forward instead of stamping frames in the past
+        clockPending = true;
         checkUpgrade();
         return res;
     }
 
+    bool Stream::requestKeyframe() const {
+        if (const auto pc = connection.lock(); pc && hasVideo) {
+            pc->encoderControl()->requestKeyframe();
+            return true;
+        }
+        return false;
+    }
+
     bool Stream::mute() const {
         if (!audioTrack->isMuted() || !videoTrack->isMuted()) {
             audioTrack->Mute(true);
@@ -203,6 +332,9 @@ namespace ntgcalls {
     }
 
     void Stream::stop() {
+        if (running) {
+            UplinkBudget::leave(this);
+        }
         running = false;
         idling = false;
         changing = false;
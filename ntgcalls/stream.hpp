@@ -5,8 +5,12 @@
 #pragma once
 
 
+#include <atomic>
+#include <condition_variable>
+
 #include "io/base_reader.hpp"
 #include "models/media_state.hpp"
+#include "models/stream_stats.hpp"
 #include "media/audio_streamer.hpp"
 #include "media/video_streamer.hpp"
 #include "utils/dispatch_queue.hpp"
@@ -14,7 +18,7 @@
 #include "media/media_reader_factory.hpp"
 
 namespace ntgcalls {
-    class Stream {
+    class Stream: public std::enable_shared_from_this<Stream> {
     public:
         enum Type {
             Audio,
@@ -30,6 +34,8 @@ namespace ntgcalls {
 
         ~Stream();
 
+        static void checkConfig(const MediaDescription& streamConfig);
+
         void setAVStream(const MediaDescription& streamConfig, bool noUpgrade = false);
 
         void start();
@@ -38,6 +44,8 @@ namespace ntgcalls {
 
         bool resume();
 
+        bool requestKeyframe() const;
+
         bool mute() const;
 
         bool unmute() const;
@@ -46,12 +54,19 @@ namespace ntgcalls {
 
         MediaState getState() const;
 
+        StreamStats getStats() const;
+
         uint64_t time() const;
 
         Status status() const;
 
         void addTracks(const std::shared_ptr<wrtc::PeerConnection> &pc);
 
+        [[nodiscard]] bool sendsVideo() const;
+
+        // Caps the video bitrate below its own maximum, 0 lifts the cap
+        void setUplinkShare(uint32_t share);
+
         void onStreamEnd(const std::function<void(Type)> &callback);
 
         void onUpgrade(const std::function<void(MediaState)> &callback);
@@ -60,19 +75,35 @@ namespace ntgcalls {
         std::shared_ptr<AudioStreamer> audio;
         std::shared_ptr<VideoStreamer> video;
         wrtc::MediaStreamTrack *audioTrack{}, *videoTrack{};
+        std::weak_ptr<wrtc::PeerConnection> connection;
         std::shared_ptr<MediaReaderFactory> reader;
-        bool running = false, idling = false, changing = false, hasVideo = false;
+        bool running = false, idling = false, changing = false, clockPending = true;
+        // Read by the uplink budget queue
+        std::atomic_bool hasVideo = false;
         wrtc::synchronized_callback<Type> onEOF;
         wrtc::synchronized_callback<MediaState> onChangeStatus;
         std::shared_ptr<DispatchQueue> streamQueue;
         std::shared_ptr<DispatchQueue> updateQueue;
         std::recursive_mutex mutex;
+        // Wakes the stream thread out of its waits when setAVStream swaps the stream, changes is guarded by mutex
+        std::condition_variable_any wake;
+        uint64_t changes = 0;
+        // Bitrates are applied from the caller of setAVStream and from the uplink budget queue
+        std::mutex bitrateMutex;
+        uint32_t audioMinBitrate = 0, audioMaxBitrate = 0, videoMinBitrate = 0, videoMaxBitrate = 0, uplinkShare = 0;
+
+        void applyBitrate();
 
         void sendSample();
 
         void checkStream() const;
 
-        std::pair<std::shared_ptr<BaseStreamer>, std::shared_ptr<BaseReader>> unsafePrepareForSample() const;
+        void resetClock() const;
+
+        void sendSyncedVideo() const;
+
+        // Waits for the next frame with the lock released
+        std::pair<std::shared_ptr<BaseStreamer>, std::shared_ptr<BaseReader>> unsafePrepareForSample(std::unique_lock<std::recursive_mutex>& lock);
 
         void checkUpgrade() const;
     };
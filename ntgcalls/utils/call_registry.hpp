@@ -0,0 +1,78 @@
+//
+// Created by Laky64 on 18/10/2026.
+//
+
+#pragma once
+
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <vector>
+
+#include "concurrent_map.hpp"
+#include "dispatch_queue.hpp"
+
+namespace ntgcalls {
+
+    // Chat id to client registry behind NTgCalls, a template so the stress test can drive it with fake clients.
+    // Client needs a default constructor and stop(), Pool needs take(layers) and restore(client)
+    template <typename Client, typename Pool>
+    class CallRegistry {
+        ConcurrentMap<int64_t, Client> connections;
+        // Declared last, so pending stops are joined or discarded before the map goes away
+        std::shared_ptr<DispatchQueue> cleanupQueue = std::make_shared<DispatchQueue>();
+
+    public:
+        // Nullptr when the chat is already registered, a warm client taken for it goes back to the pool
+        std::shared_ptr<Client> add(const int64_t chatId, Pool& pool, const uint8_t simulcastLayers) {
+            if (connections.contains(chatId)) {
+                return nullptr;
+            }
+            auto client = pool.take(simulcastLayers);
+            const bool warm = client != nullptr;
+            if (!warm) {
+                client = std::make_shared<Client>();
+            }
+            if (!connections.insert(chatId, client)) {
+                // Lost the race against another call on the same chat
+                if (warm) {
+                    pool.restore(client);
+                }
+                return nullptr;
+            }
+            return client;
+        }
+
+        // Only removes the chat while it still holds this client, a newer call on the same chat is kept
+        void remove(const int64_t chatId, const Client* client) {
+            if (auto removed = connections.erase(chatId, client)) {
+                // Failures can be reported on the signaling thread, closing the connection there would deadlock
+                cleanupQueue->dispatch([removed = std::move(removed)] {
+                    removed->stop();
+                });
+            }
+        }
+
+        // Removed before it is stopped, so concurrent calls on the same chat never see a stopped client
+        std::shared_ptr<Client> erase(const int64_t chatId) {
+            return connections.erase(chatId);
+        }
+
+        std::shared_ptr<Client> find(const int64_t chatId) const {
+            return connections.find(chatId);
+        }
+
+        bool contains(const int64_t chatId) const {
+            return connections.contains(chatId);
+        }
+
+        std::map<int64_t, std::shared_ptr<Client>> snapshot() const {
+            return connections.snapshot();
+        }
+
+        std::vector<std::shared_ptr<Client>> clear() {
+            return connections.clear();
+        }
+    };
+
+} // ntgcalls
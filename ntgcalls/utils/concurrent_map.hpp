@@ -0,0 +1,103 @@
+//
+// Created by Laky64 on 18/10/2026.
+//
+
+#pragma once
+
+#include <array>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <vector>
+
+namespace ntgcalls {
+
+    // Map of shared pointers split into independently locked shards, lookups only take a shared lock on one shard
+    template <typename Key, typename Value, size_t ShardCount = 16>
+    class ConcurrentMap {
+        struct Shard {
+            mutable std::shared_mutex mutex;
+            std::map<Key, std::shared_ptr<Value>> items;
+        };
+        std::array<Shard, ShardCount> shards;
+
+        Shard& shardOf(const Key& key) {
+            return shards[std::hash<Key>{}(key) % ShardCount];
+        }
+
+        const Shard& shardOf(const Key& key) const {
+            return shards[std::hash<Key>{}(key) % ShardCount];
+        }
+
+    public:
+        // Returns false without replacing anything when the key is already present
+        bool insert(const Key& key, const std::shared_ptr<Value>& value) {
+            auto& shard = shardOf(key);
+            std::unique_lock lock(shard.mutex);
+            return shard.items.emplace(key, value).second;
+        }
+
+        std::shared_ptr<Value> find(const Key& key) const {
+            const auto& shard = shardOf(key);
+            std::shared_lock lock(shard.mutex);
+            const auto it = shard.items.find(key);
+            return it != shard.items.end() ? it->second : nullptr;
+        }
+
+        bool contains(const Key& key) const {
+            const auto& shard = shardOf(key);
+            std::shared_lock lock(shard.mutex);
+            return shard.items.contains(key);
+        }
+
+        // Returns the removed value, so it can be released outside the lock
+        std::shared_ptr<Value> erase(const Key& key) {
+            auto& shard = shardOf(key);
+            std::unique_lock lock(shard.mutex);
+            const auto it = shard.items.find(key);
+            if (it == shard.items.end()) {
+                return nullptr;
+            }
+            auto value = std::move(it->second);
+            shard.items.erase(it);
+            return value;
+        }
+
+        // Only removes the entry while it still holds this value, a newer one under the same key is kept
+        std::shared_ptr<Value> erase(const Key& key, const Value* value) {
+            auto& shard = shardOf(key);
+            std::unique_lock lock(shard.mutex);
+            const auto it = shard.items.find(key);
+            if (it == shard.items.end() || it->second.get() != value) {
+                return nullptr;
+            }
+            auto removed = std::move(it->second);
+            shard.items.erase(it);
+            return removed;
+        }
+
+        // Consistent per shard, not across shards
+        std::map<Key, std::shared_ptr<Value>> snapshot() const {
+            std::map<Key, std::shared_ptr<Value>> items;
+            for (const auto& shard : shards) {
+                std::shared_lock lock(shard.mutex);
+                items.insert(shard.items.begin(), shard.items.end());
+            }
+            return items;
+        }
+
+        std::vector<std::shared_ptr<Value>> clear() {
+            std::vector<std::shared_ptr<Value>> values;
+            for (auto& shard : shards) {
+                std::unique_lock lock(shard.mutex);
+                for (auto& [key, value] : shard.items) {
+                    values.push_back(std::move(value));
+                }
+                shard.items.clear();
+            }
+            return values;
+        }
+    };
+
+} // ntgcalls
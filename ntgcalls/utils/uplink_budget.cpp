@@ -0,0 +1,72 @@
+//
+// Created by Laky64 on 18/10/2026.
+//
+
+#include "uplink_budget.hpp"
+
+#include <algorithm>
+#include <utility>
+
+#include <wrtc/wrtc.hpp>
+#include "../stream.hpp"
+
+namespace ntgcalls {
+    std::mutex UplinkBudget::mutex{};
+    std::vector<std::weak_ptr<Stream>> UplinkBudget::streams{};
+    std::shared_ptr<DispatchQueue> UplinkBudget::queue{};
+    bool UplinkBudget::capped = false;
+
+    void UplinkBudget::join(const std::weak_ptr<Stream>& stream) {
+        std::lock_guard lock(mutex);
+        streams.push_back(stream);
+        schedule();
+    }
+
+    void UplinkBudget::leave(const Stream* stream) {
+        std::lock_guard lock(mutex);
+        std::erase_if(streams, [stream](const std::weak_ptr<Stream>& weak) {
+            const auto locked = weak.lock();
+            return !locked || locked.get() == stream;
+        });
+        schedule();
+    }
+
+    void UplinkBudget::update() {
+        std::lock_guard lock(mutex);
+        schedule();
+    }
+
+    void UplinkBudget::schedule() {
+        if (!queue) {
+            queue = std::make_shared<DispatchQueue>();
+        }
+        queue->dispatch([] {
+            rebalance();
+        });
+    }
+
+    void UplinkBudget::rebalance() {
+        std::vector<std::shared_ptr<Stream>> active;
+        {
+            std::lock_guard lock(mutex);
+            for (const auto& weak : streams) {
+                if (auto stream = weak.lock()) {
+                    active.push_back(std::move(stream));
+                }
+            }
+        }
+        const auto budget = wrtc::PeerConnectionFactory::GetConfig().uplinkBudget;
+        // Nothing to lift when no share was ever applied
+        if (!budget && !std::exchange(capped, false)) {
+            return;
+        }
+        capped = budget != 0;
+        const auto senders = std::count_if(active.begin(), active.end(), [](const std::shared_ptr<Stream>& stream) {
+            return stream->sendsVideo();
+        });
+        const auto share = budget && senders ? static_cast<uint32_t>(budget / senders) : 0;
+        for (const auto& stream : active) {
+            stream->setUplinkShare(stream->sendsVideo() ? share : 0);
+        }
+    }
+} // ntgcalls
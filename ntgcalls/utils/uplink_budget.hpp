@@ -0,0 +1,37 @@
+//
+// Created by Laky64 on 18/10/2026.
+//
+
+#pragma once
+
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "dispatch_queue.hpp"
+
+namespace ntgcalls {
+    class Stream;
+
+    // Uplink budget of the factory config, split evenly across the video of the streams that are sending
+    class UplinkBudget {
+        static std::mutex mutex;
+        static std::vector<std::weak_ptr<Stream>> streams;
+        // Shares are applied here, never on a signaling thread nor under the mutex
+        static std::shared_ptr<DispatchQueue> queue;
+        static bool capped;
+
+        static void rebalance();
+
+        static void schedule();
+
+    public:
+        static void join(const std::weak_ptr<Stream>& stream);
+
+        static void leave(const Stream* stream);
+
+        // A stream started or stopped sending video
+        static void update();
+    };
+
+} // ntgcalls
@@ -0,0 +1,156 @@
+//
+// Created by Laky64 on 18/10/2026.
+//
+
+#include "warm_pool.hpp"
+
+#include <algorithm>
+#include <chrono>
+
+namespace ntgcalls {
+    WarmPool::~WarmPool() {
+        // Wakes a pending retry, the queue is joined right after
+        clear();
+    }
+
+    void WarmPool::setSize(const uint32_t poolSize) {
+        std::deque<std::shared_ptr<Client>> released;
+        {
+            std::lock_guard lock(mutex);
+            size = poolSize;
+            while (ready.size() > size) {
+                released.push_back(std::move(ready.back()));
+                ready.pop_back();
+            }
+        }
+        retryWait.notify_all();
+        refillLater();
+    }
+
+    void WarmPool::refill() {
+        std::vector<std::shared_ptr<Client>> clients;
+        {
+            std::lock_guard lock(mutex);
+            for (auto missing = size - std::min<size_t>(size, ready.size() + preparing.size()); missing; missing--) {
+                clients.push_back(std::make_shared<Client>());
+                preparing.push_back(clients.back());
+            }
+        }
+        // Creating the connection waits on the signaling thread, which may be waiting on the mutex in finish
+        for (const auto& client : clients) {
+            const std::weak_ptr weak(weak_from_this());
+            try {
+                client->prepare(1, [weak, client = client.get()] {
+                    if (const auto pool = weak.lock()) {
+                        pool->finish(client, true);
+                    }
+                }, [weak, client = client.get()](const std::exception_ptr&) {
+                    if (const auto pool = weak.lock()) {
+                        pool->finish(client, false);
+                    }
+                });
+            } catch (...) {
+                finish(client.get(), false);
+            }
+        }
+    }
+
+    void WarmPool::refillLater() {
+        queue->dispatch([this] {
+            refill();
+        });
+    }
+
+    void WarmPool::retryLater() {
+        retryQueue->dispatch([this] {
+            std::unique_lock lock(mutex);
+            // 2, 4, 8, 16 and then 30 seconds while preparing keeps failing
+            const auto delay = std::chrono::seconds(std::min<uint32_t>(1u << std::min<uint32_t>(failures, 5), 30));
+            const auto cancelled = retryWait.wait_for(lock, delay, [this] {
+                return !size;
+            });
+            retrying = false;
+            lock.unlock();
+            if (!cancelled) {
+                refillLater();
+            }
+        });
+    }
+
+    void WarmPool::finish(const Client* client, const bool succeeded) {
+        std::shared_ptr<Client> released;
+        bool retry = false;
+        {
+            std::lock_guard lock(mutex);
+            const auto it = std::find_if(preparing.begin(), preparing.end(), [client](const auto& c) {
+                return c.get() == client;
+            });
+            if (it == preparing.end()) {
+                return;
+            }
+            if (succeeded && ready.size() < size) {
+                ready.push_back(*it);
+            } else {
+                released = *it;
+            }
+            preparing.erase(it);
+            failures = succeeded ? 0 : failures + 1;
+            retry = !succeeded && size && !std::exchange(retrying, true);
+        }
+        if (released) {
+            // Closing a connection from the signaling thread it runs on would deadlock
+            queue->dispatch([released = std::move(released)] {});
+        }
+        if (retry) {
+            retryLater();
+        }
+    }
+
+    std::shared_ptr<Client> WarmPool::take(const uint8_t simulcastLayers) {
+        std::shared_ptr<Client> client;
+        {
+            std::lock_guard lock(mutex);
+            if (!size) {
+                return nullptr;
+            }
+            if (simulcastLayers > 1 || ready.empty()) {
+                misses++;
+                return nullptr;
+            }
+            client = std::move(ready.front());
+            ready.pop_front();
+            hits++;
+        }
+        refillLater();
+        return client;
+    }
+
+    void WarmPool::restore(const std::shared_ptr<Client>& client) {
+        std::lock_guard lock(mutex);
+        hits--;
+        // Otherwise the refill after the take already replaced it, the caller drops the last reference
+        if (ready.size() < size) {
+            ready.push_front(client);
+        }
+    }
+
+    WarmPoolStats WarmPool::stats() {
+        std::lock_guard lock(mutex);
+        return {
+            size,
+            static_cast<uint32_t>(ready.size()),
+            hits,
+            misses,
+        };
+    }
+
+    void WarmPool::clear() {
+        std::deque<std::shared_ptr<Client>> released;
+        {
+            std::lock_guard lock(mutex);
+            size = 0;
+            released.swap(ready);
+        }
+        retryWait.notify_all();
+    }
+} // ntgcalls
@@ -0,0 +1,60 @@
+//
+// Created by Laky64 on 18/10/2026.
+//
+
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "client.hpp"
+#include "models/warm_pool_stats.hpp"
+#include "utils/dispatch_queue.hpp"
+
+namespace ntgcalls {
+
+    // Clients with their connection created and a single layer offer applied, refilled in the background
+    class WarmPool: public std::enable_shared_from_this<WarmPool> {
+        std::mutex mutex;
+        std::deque<std::shared_ptr<Client>> ready;
+        // Owned here while their offer is created, so the signaling thread never drops the last reference
+        std::vector<std::shared_ptr<Client>> preparing;
+        uint32_t size = 0;
+        uint64_t hits = 0, misses = 0;
+        // Failed prepares in a row, the retry backs off with them
+        uint32_t failures = 0;
+        bool retrying = false;
+        std::condition_variable retryWait;
+        // Refills and releases run here, declared after what its tasks touch so it is joined first
+        std::shared_ptr<DispatchQueue> queue = std::make_shared<DispatchQueue>();
+        // The retry backoff waits here, so refills after a take never queue behind it. Joined before the queue it refills on
+        std::shared_ptr<DispatchQueue> retryQueue = std::make_shared<DispatchQueue>();
+
+        void refill();
+
+        void refillLater();
+
+        void retryLater();
+
+        void finish(const Client* client, bool succeeded);
+
+    public:
+        ~WarmPool();
+
+        void setSize(uint32_t poolSize);
+
+        // Nullptr when the pool is empty or the call needs a simulcast offer
+        std::shared_ptr<Client> take(uint8_t simulcastLayers);
+
+        // Gives back a taken client that never got a call, it no longer counts as a hit
+        void restore(const std::shared_ptr<Client>& client);
+
+        WarmPoolStats stats();
+
+        void clear();
+    };
+
+} // ntgcalls
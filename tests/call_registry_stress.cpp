@@ -0,0 +1,158 @@
+//
+// Created by Laky64 on 18/10/2026.
+//
+
+// Drives the NTgCalls registry with fake clients from several threads: createCall and stop on the same chats,
+// init failures reported from another thread and the registry torn down with stops still queued.
+// Meant to run under -fsanitize=thread
+
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <deque>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "ntgcalls/utils/call_registry.hpp"
+
+namespace {
+    std::atomic_uint64_t doubleStops = 0, stopped = 0;
+
+    struct FakeClient {
+        std::atomic_uint32_t stops = 0, uses = 0;
+        bool warm = false;
+
+        void stop() {
+            if (stops++) {
+                doubleStops++;
+            }
+            stopped++;
+        }
+    };
+
+    // Same contract as WarmPool, always keeps one client ready
+    class FakePool {
+        std::mutex mutex;
+        std::deque<std::shared_ptr<FakeClient>> ready;
+        uint64_t hits = 0;
+
+        static std::shared_ptr<FakeClient> warmClient() {
+            auto client = std::make_shared<FakeClient>();
+            client->warm = true;
+            return client;
+        }
+
+    public:
+        std::shared_ptr<FakeClient> take(const uint8_t simulcastLayers) {
+            std::lock_guard lock(mutex);
+            if (simulcastLayers > 1) {
+                return nullptr;
+            }
+            if (ready.empty()) {
+                ready.push_back(warmClient());
+            }
+            auto client = std::move(ready.front());
+            ready.pop_front();
+            ready.push_back(warmClient());
+            hits++;
+            return client;
+        }
+
+        void restore(const std::shared_ptr<FakeClient>& client) {
+            std::lock_guard lock(mutex);
+            hits--;
+            ready.push_front(client);
+        }
+
+        uint64_t hitCount() {
+            std::lock_guard lock(mutex);
+            return hits;
+        }
+    };
+}
+
+int main() {
+    constexpr int threadCount = 8;
+    constexpr int iterations = 5000;
+    constexpr int64_t chatCount = 8;
+
+    FakePool pool;
+    std::atomic_uint64_t registered = 0, warmRegistered = 0;
+    auto registry = std::make_unique<ntgcalls::CallRegistry<FakeClient, FakePool>>();
+    {
+        // Init failures arrive on the signaling thread, joined at the end of this block while the registry is still alive
+        DispatchQueue signaling;
+        std::vector<std::thread> threads;
+        threads.reserve(threadCount);
+        for (int t = 0; t < threadCount; t++) {
+            threads.emplace_back([&, t] {
+                for (int i = 0; i < iterations; i++) {
+                    const auto chatId = static_cast<int64_t>((i * 13 + t * 5) % chatCount);
+                    switch ((i + t) % 5) {
+                        case 0:
+                        case 1:
+                            // createCall, every other one fails its init
+                            if (const auto client = registry->add(chatId, pool, static_cast<uint8_t>(i % 3 ? 1 : 2))) {
+                                registered++;
+                                if (client->warm) {
+                                    warmRegistered++;
+                                }
+                                if (i % 2) {
+                                    signaling.dispatch([&registry, chatId, client] {
+                                        registry->remove(chatId, client.get());
+                                    });
+                                } else if (i % 4 == 0) {
+                                    registry->remove(chatId, client.get());
+                                }
+                            }
+                            break;
+                        case 2:
+                            // stop
+                            if (const auto client = registry->erase(chatId)) {
+                                client->stop();
+                            }
+                            break;
+                        case 3:
+                            if (const auto client = registry->find(chatId)) {
+                                client->uses++;
+                            }
+                            break;
+                        default:
+                            for (const auto& [id, client] : registry->snapshot()) {
+                                client->uses++;
+                            }
+                            (void) registry->contains(chatId);
+                            break;
+                    }
+                }
+            });
+        }
+        for (auto& thread : threads) {
+            thread.join();
+        }
+    }
+    for (const auto& client : registry->clear()) {
+        client->stop();
+    }
+    // Stops still queued on the cleanup queue are joined or dropped here
+    registry = nullptr;
+
+    bool failed = false;
+    if (doubleStops) {
+        std::cerr << doubleStops << " clients stopped more than once" << std::endl;
+        failed = true;
+    }
+    if (stopped > registered) {
+        std::cerr << "stopped " << stopped << " clients out of " << registered << " registered" << std::endl;
+        failed = true;
+    }
+    // A warm client that lost the insert race must go back to the pool instead of counting as a hit
+    if (pool.hitCount() != warmRegistered) {
+        std::cerr << "pool hits " << pool.hitCount() << ", warm clients registered " << warmRegistered << std::endl;
+        failed = true;
+    }
+    return failed ? EXIT_FAILURE : EXIT_SUCCESS;
+}
@@ -0,0 +1,79 @@
+//
+// Created by Laky64 on 18/10/2026.
+//
+
+// Hammers ConcurrentMap from several threads the way NTgCalls does, meant to run under -fsanitize=thread
+
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+#include "ntgcalls/utils/concurrent_map.hpp"
+
+namespace {
+    struct Value {
+        std::atomic_uint64_t hits = 0;
+    };
+}
+
+int main() {
+    constexpr int threadCount = 8;
+    constexpr int iterations = 20000;
+    constexpr int64_t keyCount = 64;
+
+    ntgcalls::ConcurrentMap<int64_t, Value> map;
+    std::atomic_uint64_t inserted = 0, erased = 0;
+    std::vector<std::thread> threads;
+    threads.reserve(threadCount);
+    for (int t = 0; t < threadCount; t++) {
+        threads.emplace_back([&, t] {
+            for (int i = 0; i < iterations; i++) {
+                const auto key = static_cast<int64_t>((i * 31 + t * 7) % keyCount);
+                switch ((i + t) % 6) {
+                    case 0:
+                        if (map.insert(key, std::make_shared<Value>())) {
+                            inserted++;
+                        }
+                        break;
+                    case 1:
+                        if (const auto value = map.find(key)) {
+                            value->hits++;
+                        }
+                        break;
+                    case 2:
+                        if (map.erase(key)) {
+                            erased++;
+                        }
+                        break;
+                    case 3:
+                        (void) map.contains(key);
+                        break;
+                    case 4:
+                        // Same as a failed init, only the entry that was looked up goes away
+                        if (const auto value = map.find(key); value && map.erase(key, value.get())) {
+                            erased++;
+                        }
+                        break;
+                    default:
+                        for (const auto& [k, value] : map.snapshot()) {
+                            value->hits++;
+                        }
+                        break;
+                }
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    const auto left = map.clear().size();
+    if (inserted != erased + left) {
+        std::cerr << "inserted " << inserted << ", erased " << erased << ", left " << left << std::endl;
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,68 @@
+//
+// Created by Laky64 on 18/10/2026.
+//
+
+// Times RawImageData::buffer, the copy or conversion every pushed frame goes through, for each PixelFormat
+
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <utility>
+#include <vector>
+#include <common_video/include/video_frame_buffer_pool.h>
+
+#include "wrtc/models/raw_image_data.hpp"
+
+namespace {
+    constexpr int frames = 300;
+
+    const std::vector<std::pair<wrtc::PixelFormat, const char*>> formats = {
+        {wrtc::PixelFormat::I420, "I420"},
+        {wrtc::PixelFormat::NV12, "NV12"},
+        {wrtc::PixelFormat::RGB24, "RGB24"},
+        {wrtc::PixelFormat::RGBA, "RGBA"},
+        {wrtc::PixelFormat::BGRA, "BGRA"},
+        {wrtc::PixelFormat::YUYV, "YUYV"},
+        {wrtc::PixelFormat::UYVY, "UYVY"},
+    };
+
+    const std::vector<std::pair<uint16_t, uint16_t>> sizes = {
+        {1280, 720},
+        {1920, 1080},
+    };
+}
+
+int main() {
+    std::mt19937 random(42);
+    // Same pool the video source keeps, so buffers are reused like they are while streaming
+    webrtc::VideoFrameBufferPool pool;
+    std::cout << std::fixed << std::setprecision(1);
+    for (const auto& [width, height] : sizes) {
+        for (const auto& [format, name] : formats) {
+            const auto size = wrtc::RawImageData::frameSize(format, width, height);
+            const wrtc::binary contents(new uint8_t[size]);
+            for (int64_t i = 0; i < size; i++) {
+                contents[i] = static_cast<uint8_t>(random());
+            }
+            const wrtc::RawImageData image(width, height, format, contents);
+            // Warms up the pool and the caches
+            (void) image.buffer(pool);
+
+            const auto start = std::chrono::steady_clock::now();
+            for (int i = 0; i < frames; i++) {
+                if (!image.buffer(pool)) {
+                    std::cerr << name << ": no buffer available in the pool" << std::endl;
+                    return EXIT_FAILURE;
+                }
+            }
+            const auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            std::cout << width << "x" << height << " " << std::setw(5) << name << ": "
+                      << elapsed / frames * 1e6 << " us/frame, "
+                      << static_cast<double>(size) * frames / elapsed / 1e6 << " MB/s" << std::endl;
+        }
+    }
+    return EXIT_SUCCESS;
+}
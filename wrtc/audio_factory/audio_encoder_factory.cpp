@@ -0,0 +1,50 @@
+//
+// Created by Laky64 on 18/10/2026.
+//
+
+#include "audio_encoder_factory.hpp"
+
+#include <api/audio_codecs/audio_encoder_factory_template.h>
+#include <api/audio_codecs/g711/audio_encoder_g711.h>
+#include <api/audio_codecs/g722/audio_encoder_g722.h>
+#include <rtc_base/string_to_number.h>
+
+namespace wrtc {
+
+    absl::optional<OpusEncoder::Config> OpusEncoder::SdpToConfig(const webrtc::SdpAudioFormat& format) {
+        auto config = webrtc::AudioEncoderOpus::SdpToConfig(format);
+        if (!config) {
+            return config;
+        }
+        if (const auto it = format.parameters.find("x-ntg-complexity"); it != format.parameters.end()) {
+            if (const auto complexity = rtc::StringToNumber<int>(it->second); complexity && *complexity >= 0 && *complexity <= 10) {
+                config->complexity = *complexity;
+                config->low_rate_complexity = *complexity;
+            }
+        }
+        return config;
+    }
+
+    void OpusEncoder::AppendSupportedEncoders(std::vector<webrtc::AudioCodecSpec>* specs) {
+        webrtc::AudioEncoderOpus::AppendSupportedEncoders(specs);
+    }
+
+    webrtc::AudioCodecInfo OpusEncoder::QueryAudioEncoder(const Config& config) {
+        return webrtc::AudioEncoderOpus::QueryAudioEncoder(config);
+    }
+
+    std::unique_ptr<webrtc::AudioEncoder> OpusEncoder::MakeAudioEncoder(
+        const Config& config,
+        const int payloadType,
+        const absl::optional<webrtc::AudioCodecPairId> codecPairId,
+        const webrtc::FieldTrialsView* fieldTrials
+    ) {
+        return webrtc::AudioEncoderOpus::MakeAudioEncoder(config, payloadType, codecPairId, fieldTrials);
+    }
+
+    rtc::scoped_refptr<webrtc::AudioEncoderFactory> CreateAudioEncoderFactory() {
+        // G711 and G722 are kept so that telephone-event/8000 is still offered
+        return webrtc::CreateAudioEncoderFactory<OpusEncoder, webrtc::AudioEncoderG722, webrtc::AudioEncoderG711>();
+    }
+
+} // wrtc
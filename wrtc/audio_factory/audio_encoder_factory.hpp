@@ -0,0 +1,32 @@
+//
+// Created by Laky64 on 18/10/2026.
+//
+
+#pragma once
+
+#include <api/audio_codecs/audio_encoder_factory.h>
+#include <api/audio_codecs/opus/audio_encoder_opus.h>
+
+namespace wrtc {
+
+    // Same as webrtc::AudioEncoderOpus, but also honours the complexity sent by SdpBuilder
+    struct OpusEncoder {
+        using Config = webrtc::AudioEncoderOpusConfig;
+
+        static absl::optional<Config> SdpToConfig(const webrtc::SdpAudioFormat& format);
+
+        static void AppendSupportedEncoders(std::vector<webrtc::AudioCodecSpec>* specs);
+
+        static webrtc::AudioCodecInfo QueryAudioEncoder(const Config& config);
+
+        static std::unique_ptr<webrtc::AudioEncoder> MakeAudioEncoder(
+            const Config& config,
+            int payloadType,
+            absl::optional<webrtc::AudioCodecPairId> codecPairId = absl::nullopt,
+            const webrtc::FieldTrialsView* fieldTrials = nullptr
+        );
+    };
+
+    rtc::scoped_refptr<webrtc::AudioEncoderFactory> CreateAudioEncoderFactory();
+
+} // wrtc
@@ -12,6 +12,52 @@ namespace wrtc {
     typedef uint32_t SSRC;
     typedef int32_t TgSSRC;
 
+    enum class AudioProfile: int {
+        Voice,
+        Music
+    };
+
+    enum class IceProfile: int {
+        Standard,
+        Restricted
+    };
+
+    enum class PixelFormat: int {
+        I420,
+        NV12,
+        RGB24,
+        RGBA,
+        BGRA,
+        YUYV,
+        UYVY
+    };
+
+    enum class VideoCodec: int {
+        VP8,
+        VP9,
+        AV1
+    };
+
+    enum class EncoderPreset: int {
+        Default,
+        Quality
+    };
+
+    enum class ContentHint: int {
+        Generic,
+        Motion,
+        Detail,
+        Text
+    };
+
+    enum class DegradationPreference: int {
+        Auto,
+        Balanced,
+        MaintainFramerate,
+        MaintainResolution,
+        Disabled
+    };
+
     enum class IceState: int {
         Unknown,
         New,
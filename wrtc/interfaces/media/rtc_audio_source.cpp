@@ -7,18 +7,18 @@
 
 namespace wrtc {
     RTCAudioSource::RTCAudioSource() {
-        factory = PeerConnectionFactory::GetOrCreateDefault();
         source = new rtc::RefCountedObject<AudioTrackSource>();
     }
 
     RTCAudioSource::~RTCAudioSource() {
         factory = nullptr;
         source = nullptr;
-        PeerConnectionFactory::UnRef();
     }
 
-    MediaStreamTrack *RTCAudioSource::createTrack() const
+    MediaStreamTrack *RTCAudioSource::createTrack(const rtc::scoped_refptr<PeerConnectionFactory>& trackFactory)
     {
+        // Kept alive for as long as the source, the track proxies run on its threads
+        factory = trackFactory;
         return MediaStreamTrack::holder()->GetOrCreate(
             factory->factory()->CreateAudioTrack(rtc::CreateRandomUuid(), source.get())
         );
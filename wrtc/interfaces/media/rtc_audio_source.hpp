@@ -19,7 +19,8 @@ namespace wrtc {
 
         ~RTCAudioSource();
 
-        [[nodiscard]] MediaStreamTrack *createTrack() const;
+        // The track must come from the factory of the PeerConnection it is added to
+        [[nodiscard]] MediaStreamTrack *createTrack(const rtc::scoped_refptr<PeerConnectionFactory>& trackFactory);
 
         void OnData(const RTCOnDataEvent &) const;
 
@@ -6,30 +6,42 @@
 
 namespace wrtc {
     RTCVideoSource::RTCVideoSource() {
-        factory = PeerConnectionFactory::GetOrCreateDefault();
         source = new rtc::RefCountedObject<VideoTrackSource>();
     }
 
     RTCVideoSource::~RTCVideoSource() {
         factory = nullptr;
         source = nullptr;
-        PeerConnectionFactory::UnRef();
     }
 
-    MediaStreamTrack *RTCVideoSource::createTrack() const
+    MediaStreamTrack *RTCVideoSource::createTrack(const rtc::scoped_refptr<PeerConnectionFactory>& trackFactory)
     {
+        // Kept alive for as long as the source, the track proxies run on its threads
+        factory = trackFactory;
         return MediaStreamTrack::holder()->GetOrCreate(
             factory->factory()->CreateVideoTrack(source, rtc::CreateRandomUuid())
         );
     }
 
-    void RTCVideoSource::OnFrame(const i420ImageData& data) const
+    void RTCVideoSource::setAdaptation(const bool enabled) const {
+        source->setAdaptation(enabled);
+    }
+
+    void RTCVideoSource::setMaxPixelCount(const std::optional<int> maxPixelCount) const {
+        source->setMaxPixelCount(maxPixelCount ? absl::optional<int>(*maxPixelCount) : absl::nullopt);
+    }
+
+    void RTCVideoSource::OnFrame(const RawImageData& data, const std::chrono::microseconds timestamp)
     {
+        const auto buffer = data.buffer(pool);
+        if (!buffer) {
+            return;
+        }
         source->PushFrame(webrtc::VideoFrame::Builder()
-            .set_video_frame_buffer(data.buffer())
-            .set_timestamp_rtp(0)
-            .set_timestamp_ms(rtc::TimeMillis())
-            .set_timestamp_us(rtc::TimeMicros())
+            .set_video_frame_buffer(buffer)
+            // The encoder derives the RTP timestamp from the capture time, this keeps both on the 90 kHz clock
+            .set_timestamp_rtp(static_cast<uint32_t>(timestamp.count() * 90 / rtc::kNumMicrosecsPerMillisec))
+            .set_timestamp_us(timestamp.count())
             .set_rotation(webrtc::kVideoRotation_0)
             .build()
         );
@@ -4,11 +4,13 @@
 
 #pragma once
 
+#include <chrono>
+#include <optional>
 #include <rtc_base/ref_count.h>
 
 #include "tracks/video_track_source.hpp"
 #include "tracks/media_stream_track.hpp"
-#include "../../models/i420_image_data.hpp"
+#include "../../models/raw_image_data.hpp"
 #include "../peer_connection/peer_connection_factory.hpp"
 
 namespace wrtc {
@@ -19,13 +21,19 @@ namespace wrtc {
 
         ~RTCVideoSource();
 
-        [[nodiscard]] MediaStreamTrack *createTrack() const;
+        // The track must come from the factory of the PeerConnection it is added to
+        [[nodiscard]] MediaStreamTrack *createTrack(const rtc::scoped_refptr<PeerConnectionFactory>& trackFactory);
 
-        void OnFrame(const i420ImageData& data) const;
+        void OnFrame(const RawImageData& data, std::chrono::microseconds timestamp);
+
+        void setAdaptation(bool enabled) const;
+
+        void setMaxPixelCount(std::optional<int> maxPixelCount) const;
 
     private:
         rtc::scoped_refptr<VideoTrackSource> source;
         rtc::scoped_refptr<PeerConnectionFactory> factory;
+        webrtc::VideoFrameBufferPool pool;
     };
 
 } // wrtc
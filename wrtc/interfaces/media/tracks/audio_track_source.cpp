@@ -36,7 +36,7 @@ namespace wrtc {
                     static_cast<int>(data.sampleRate),
                     data.channelCount,
                     data.numberOfFrames,
-                    rtc::TimeMillis()
+                    data.timestamp.count() ? data.timestamp.count() / rtc::kNumMicrosecsPerMillisec : rtc::TimeMillis()
             );
         }
     }
@@ -46,6 +46,27 @@ namespace wrtc {
         }
     }
 
+    void MediaStreamTrack::setContentHint(const ContentHint hint) const {
+        if (_track->kind() != webrtc::MediaStreamTrackInterface::kVideoKind) {
+            return;
+        }
+        auto contentHint = webrtc::VideoTrackInterface::ContentHint::kNone;
+        switch (hint) {
+            case ContentHint::Generic:
+                break;
+            case ContentHint::Motion:
+                contentHint = webrtc::VideoTrackInterface::ContentHint::kFluid;
+                break;
+            case ContentHint::Detail:
+                contentHint = webrtc::VideoTrackInterface::ContentHint::kDetailed;
+                break;
+            case ContentHint::Text:
+                contentHint = webrtc::VideoTrackInterface::ContentHint::kText;
+                break;
+        }
+        static_cast<webrtc::VideoTrackInterface*>(_track.get())->set_content_hint(contentHint);
+    }
+
     rtc::scoped_refptr<webrtc::MediaStreamTrackInterface> MediaStreamTrack::track() {
         return _track;
     }
@@ -5,6 +5,7 @@
 #pragma once
 
 #include <api/media_stream_interface.h>
+#include "../../../enums.hpp"
 #include "../../../utils/instance_holder.hpp"
 
 namespace wrtc {
@@ -25,6 +26,8 @@ namespace wrtc {
 
         void Mute(bool);
 
+        void setContentHint(ContentHint hint) const;
+
         static InstanceHolder<MediaStreamTrack *, rtc::scoped_refptr<webrtc::MediaStreamTrackInterface>>
         *holder();
 
@@ -27,8 +27,65 @@ namespace wrtc {
         return _needs_denoising;
     }
 
+    void VideoTrackSource::setAdaptation(const bool enabled) {
+        _adaptive = enabled;
+        if (!enabled) {
+            setMaxPixelCount(absl::nullopt);
+        }
+    }
+
+    void VideoTrackSource::setMaxPixelCount(const absl::optional<int> maxPixelCount) {
+        video_adapter()->OnOutputFormatRequest(absl::nullopt, maxPixelCount, absl::nullopt);
+    }
+
+    rtc::scoped_refptr<webrtc::VideoFrameBuffer> VideoTrackSource::scale(
+        const rtc::scoped_refptr<webrtc::VideoFrameBuffer>& buffer,
+        const int width,
+        const int height,
+        const int cropX,
+        const int cropY,
+        const int cropWidth,
+        const int cropHeight
+    ) {
+        if (buffer->type() == webrtc::VideoFrameBuffer::Type::kNV12) {
+            auto scaled = _pool.CreateNV12Buffer(width, height);
+            if (scaled) {
+                scaled->CropAndScaleFrom(*buffer->GetNV12(), cropX, cropY, cropWidth, cropHeight);
+            }
+            return scaled;
+        }
+        auto scaled = _pool.CreateI420Buffer(width, height);
+        if (scaled) {
+            scaled->CropAndScaleFrom(*buffer->ToI420(), cropX, cropY, cropWidth, cropHeight);
+        }
+        return scaled;
+    }
+
     void VideoTrackSource::PushFrame(const webrtc::VideoFrame &frame) {
-        this->OnFrame(frame);
+        if (!_adaptive) {
+            this->OnFrame(frame);
+            return;
+        }
+        // The adapter follows both the encoder overuse feedback and the limit set by setMaxPixelCount
+        int adaptedWidth, adaptedHeight, cropWidth, cropHeight, cropX, cropY;
+        if (!AdaptFrame(frame.width(), frame.height(), frame.timestamp_us(), &adaptedWidth, &adaptedHeight, &cropWidth, &cropHeight, &cropX, &cropY)) {
+            return;
+        }
+        if (adaptedWidth == frame.width() && adaptedHeight == frame.height()) {
+            this->OnFrame(frame);
+            return;
+        }
+        const auto scaled = scale(frame.video_frame_buffer(), adaptedWidth, adaptedHeight, cropX, cropY, cropWidth, cropHeight);
+        if (!scaled) {
+            return;
+        }
+        this->OnFrame(webrtc::VideoFrame::Builder()
+            .set_video_frame_buffer(scaled)
+            .set_timestamp_rtp(frame.timestamp())
+            .set_timestamp_us(frame.timestamp_us())
+            .set_rotation(frame.rotation())
+            .build()
+        );
     }
 
-} // wrtc
\ No newline at end of file
+} // wrtc
@@ -4,6 +4,7 @@
 
 #pragma once
 
+#include <common_video/include/video_frame_buffer_pool.h>
 #include <media/base/adapted_video_track_source.h>
 
 namespace wrtc {
@@ -22,9 +23,25 @@ namespace wrtc {
 
         void PushFrame(const webrtc::VideoFrame& frame);
 
+        void setAdaptation(bool enabled);
+
+        void setMaxPixelCount(absl::optional<int> maxPixelCount);
+
     private:
         bool _is_screencast;
         absl::optional<bool> _needs_denoising;
+        std::atomic<bool> _adaptive = false;
+        webrtc::VideoFrameBufferPool _pool;
+
+        rtc::scoped_refptr<webrtc::VideoFrameBuffer> scale(
+            const rtc::scoped_refptr<webrtc::VideoFrameBuffer>& buffer,
+            int width,
+            int height,
+            int cropX,
+            int cropY,
+            int cropWidth,
+            int cropHeight
+        );
     };
 
 } // wrtc
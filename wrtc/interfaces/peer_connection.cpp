@@ -3,6 +3,9 @@
 //
 
 #include "peer_connection.hpp"
+#include <api/units/time_delta.h>
+#include <p2p/base/port_allocator.h>
+
 #include "../utils/sync.hpp"
 #include "peer_connection/create_session_description_observer.hpp"
 #include "peer_connection/set_session_description_observer.hpp"
@@ -14,6 +17,21 @@ namespace wrtc {
 
         webrtc::PeerConnectionInterface::RTCConfiguration config;
         config.bundle_policy = webrtc::PeerConnectionInterface::BundlePolicy::kBundlePolicyMaxBundle;
+        if (const auto certificate = PeerConnectionFactory::Certificate(factory->config())) {
+            config.certificates.push_back(certificate);
+        }
+        const auto& factoryConfig = factory->config();
+        if (factoryConfig.iceProfile == IceProfile::Restricted) {
+            config.tcp_candidate_policy = webrtc::PeerConnectionInterface::kTcpCandidatePolicyDisabled;
+            config.candidate_network_policy = webrtc::PeerConnectionInterface::kCandidateNetworkPolicyLowCost;
+            config.port_allocator_config.flags = cricket::PORTALLOCATOR_DISABLE_TCP |
+                cricket::PORTALLOCATOR_DISABLE_STUN |
+                cricket::PORTALLOCATOR_DISABLE_RELAY |
+                cricket::PORTALLOCATOR_DISABLE_LINK_LOCAL_NETWORKS;
+        }
+        config.port_allocator_config.min_port = factoryConfig.minPort;
+        config.port_allocator_config.max_port = factoryConfig.maxPort;
+        config.disable_ipv6 = factoryConfig.disableIpv6;
 
         webrtc::PeerConnectionDependencies dependencies(this);
 
@@ -30,7 +48,7 @@ namespace wrtc {
 
     PeerConnection::~PeerConnection() {
         if (factory) {
-            PeerConnectionFactory::UnRef();
+            PeerConnectionFactory::UnRef(factory);
             factory = nullptr;
         }
         close();
@@ -39,21 +57,40 @@ namespace wrtc {
 
     Description PeerConnection::createOffer(const bool offerToReceiveAudio, const bool offerToReceiveVideo) const
     {
+        Sync<std::optional<Description>> description;
+        createOffer(offerToReceiveAudio, offerToReceiveVideo, description.onSuccess, description.onFailed);
+        return description.get();
+    }
+
+    void PeerConnection::createOffer(
+        const bool offerToReceiveAudio,
+        const bool offerToReceiveVideo,
+        const std::function<void(Description)>& onSuccess,
+        const std::function<void(const std::exception&)>& onFailed
+    ) const {
         if (!peerConnection ||
             peerConnection->signaling_state() == webrtc::PeerConnectionInterface::SignalingState::kClosed) {
             throw RTCException("Failed to execute 'createOffer' on 'PeerConnection': The PeerConnection's signalingState is 'closed'.");
         }
-        Sync<std::optional<Description>> description;
-        const auto observer = new rtc::RefCountedObject<CreateSessionDescriptionObserver>(description.onSuccess, description.onFailed);
+        const auto observer = new rtc::RefCountedObject<CreateSessionDescriptionObserver>(onSuccess, onFailed);
         auto options = webrtc::PeerConnectionInterface::RTCOfferAnswerOptions();
         options.offer_to_receive_audio = offerToReceiveAudio;
         options.offer_to_receive_video = offerToReceiveVideo;
         peerConnection->CreateOffer(observer, options);
-        return description.get();
     }
 
     void PeerConnection::setLocalDescription(const Description &description) const
     {
+        Sync<void> future;
+        setLocalDescription(description, future.onSuccess, future.onFailed);
+        future.wait();
+    }
+
+    void PeerConnection::setLocalDescription(
+        const Description &description,
+        const std::function<void()>& onSuccess,
+        const std::function<void(const std::exception&)>& onFailed
+    ) const {
         auto *raw_description = static_cast<webrtc::SessionDescriptionInterface *>(description);
         std::unique_ptr<webrtc::SessionDescriptionInterface> raw_description_ptr(raw_description);
 
@@ -62,15 +99,22 @@ namespace wrtc {
             throw RTCException("Failed to execute 'setLocalDescription' on 'PeerConnection': The PeerConnection's signalingState is 'closed'.");
         }
 
-        Sync<void> future;
-        const auto observer = new rtc::RefCountedObject<SetSessionDescriptionObserver>(future.onSuccess, future.onFailed);
+        const auto observer = new rtc::RefCountedObject<SetSessionDescriptionObserver>(onSuccess, onFailed);
         peerConnection->SetLocalDescription(observer, raw_description_ptr.release());
-
-        future.wait();
     }
 
     void PeerConnection::setRemoteDescription(const Description &description) const
     {
+        Sync<void> future;
+        setRemoteDescription(description, future.onSuccess, future.onFailed);
+        future.wait();
+    }
+
+    void PeerConnection::setRemoteDescription(
+        const Description &description,
+        const std::function<void()>& onSuccess,
+        const std::function<void(const std::exception&)>& onFailed
+    ) const {
         auto *raw_description = static_cast<webrtc::SessionDescriptionInterface *>(description);
         std::unique_ptr<webrtc::SessionDescriptionInterface> raw_description_ptr(raw_description);
 
@@ -79,11 +123,15 @@ namespace wrtc {
             throw RTCException("Failed to execute 'setRemoteDescription' on 'PeerConnection': The PeerConnection's signalingState is 'closed'.");
         }
 
-        Sync<void> future;
-        const auto observer = new rtc::RefCountedObject<SetSessionDescriptionObserver>(future.onSuccess, future.onFailed);
+        const auto observer = new rtc::RefCountedObject<SetSessionDescriptionObserver>(onSuccess, onFailed);
         peerConnection->SetRemoteDescription(observer, raw_description_ptr.release());
+    }
 
-        future.wait();
+    void PeerConnection::postDelayed(const std::chrono::milliseconds delay, std::function<void()> task) const
+    {
+        factory->signalingThread()->PostDelayedTask([task = std::move(task)] {
+            task();
+        }, webrtc::TimeDelta::Millis(delay.count()));
     }
 
     void PeerConnection::addTrack(MediaStreamTrack *mediaStreamTrack, const std::vector<std::string>& streamIds) const
@@ -96,6 +144,94 @@ namespace wrtc {
         }
     }
 
+    void PeerConnection::setDegradationPreference(MediaStreamTrack *mediaStreamTrack, const DegradationPreference preference) const
+    {
+        if (!peerConnection) {
+            throw RTCException("Cannot set degradation preference; PeerConnection is closed");
+        }
+        absl::optional<webrtc::DegradationPreference> degradationPreference;
+        switch (preference) {
+            case DegradationPreference::Auto:
+                break;
+            case DegradationPreference::Balanced:
+                degradationPreference = webrtc::DegradationPreference::BALANCED;
+                break;
+            case DegradationPreference::MaintainFramerate:
+                degradationPreference = webrtc::DegradationPreference::MAINTAIN_FRAMERATE;
+                break;
+            case DegradationPreference::MaintainResolution:
+                degradationPreference = webrtc::DegradationPreference::MAINTAIN_RESOLUTION;
+                break;
+            case DegradationPreference::Disabled:
+                degradationPreference = webrtc::DegradationPreference::DISABLED;
+                break;
+        }
+        std::lock_guard lock(sendersMutex);
+        for (const auto& sender : peerConnection->GetSenders()) {
+            if (sender->track() != mediaStreamTrack->track()) {
+                continue;
+            }
+            auto parameters = sender->GetParameters();
+            parameters.degradation_preference = degradationPreference;
+            if (const auto result = sender->SetParameters(parameters); !result.ok()) {
+                throw wrapRTCError(result);
+            }
+        }
+    }
+
+    void PeerConnection::setTemporalLayers(MediaStreamTrack *mediaStreamTrack, const uint8_t temporalLayers) const
+    {
+        if (!peerConnection) {
+            throw RTCException("Cannot set temporal layers; PeerConnection is closed");
+        }
+        absl::optional<std::string> scalabilityMode;
+        if (temporalLayers > 1) {
+            scalabilityMode = "L1T" + std::to_string(temporalLayers);
+        }
+        std::lock_guard lock(sendersMutex);
+        for (const auto& sender : peerConnection->GetSenders()) {
+            if (sender->track() != mediaStreamTrack->track()) {
+                continue;
+            }
+            auto parameters = sender->GetParameters();
+            for (auto& encoding : parameters.encodings) {
+                encoding.scalability_mode = scalabilityMode;
+            }
+            if (const auto result = sender->SetParameters(parameters); !result.ok()) {
+                throw wrapRTCError(result);
+            }
+        }
+    }
+
+    void PeerConnection::setBitrateLimits(MediaStreamTrack *mediaStreamTrack, const uint32_t minBitrate, const uint32_t maxBitrate) const
+    {
+        if (!peerConnection) {
+            throw RTCException("Cannot set bitrate limits; PeerConnection is closed");
+        }
+        // A minimum above the maximum is rejected by SetParameters
+        const auto floor = maxBitrate ? std::min(minBitrate, maxBitrate) : minBitrate;
+        std::lock_guard lock(sendersMutex);
+        for (const auto& sender : peerConnection->GetSenders()) {
+            if (sender->track() != mediaStreamTrack->track()) {
+                continue;
+            }
+            auto parameters = sender->GetParameters();
+            for (size_t i = 0; i < parameters.encodings.size(); i++) {
+                auto& encoding = parameters.encodings[i];
+                encoding.min_bitrate_bps = floor && !i ? absl::optional<int>(static_cast<int>(floor)) : absl::nullopt;
+                encoding.max_bitrate_bps = maxBitrate ? absl::optional<int>(static_cast<int>(maxBitrate)) : absl::nullopt;
+            }
+            if (const auto result = sender->SetParameters(parameters); !result.ok()) {
+                throw wrapRTCError(result);
+            }
+        }
+    }
+
+    const std::shared_ptr<EncoderControl>& PeerConnection::encoderControl() const
+    {
+        return _encoderControl;
+    }
+
     void PeerConnection::restartIce() const
     {
         if (peerConnection) {
@@ -103,6 +239,14 @@ namespace wrtc {
         }
     }
 
+    const FactoryConfig& PeerConnection::factoryConfig() const {
+        return factory->config();
+    }
+
+    const rtc::scoped_refptr<PeerConnectionFactory>& PeerConnection::peerConnectionFactory() const {
+        return factory;
+    }
+
     void PeerConnection::close() {
         if (peerConnection && !isClosed) {
             peerConnection->Close();
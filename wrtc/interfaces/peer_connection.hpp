@@ -4,6 +4,8 @@
 
 #pragma once
 
+#include <chrono>
+#include <mutex>
 #include <api/peer_connection_interface.h>
 #include "../enums.hpp"
 #include "../exceptions.hpp"
@@ -11,6 +13,7 @@
 #include "../models/rtc_session_description.hpp"
 #include "media/tracks/media_stream_track.hpp"
 #include "peer_connection/peer_connection_factory.hpp"
+#include "../video_factory/encoder_control.hpp"
 
 namespace wrtc {
 
@@ -22,14 +25,50 @@ namespace wrtc {
 
         Description createOffer(bool offerToReceiveAudio = true, bool offerToReceiveVideo = false) const;
 
+        // Non-blocking variants, callbacks run on the signaling thread
+        void createOffer(
+            bool offerToReceiveAudio,
+            bool offerToReceiveVideo,
+            const std::function<void(Description)>& onSuccess,
+            const std::function<void(const std::exception&)>& onFailed
+        ) const;
+
         void setLocalDescription(const Description &description) const;
 
+        void setLocalDescription(
+            const Description &description,
+            const std::function<void()>& onSuccess,
+            const std::function<void(const std::exception&)>& onFailed
+        ) const;
+
         void setRemoteDescription(const Description &description) const;
 
+        void setRemoteDescription(
+            const Description &description,
+            const std::function<void()>& onSuccess,
+            const std::function<void(const std::exception&)>& onFailed
+        ) const;
+
+        // Runs the task on the signaling thread once the delay has passed, the task must not outlive what it captures
+        void postDelayed(std::chrono::milliseconds delay, std::function<void()> task) const;
+
         void addTrack(MediaStreamTrack *mediaStreamTrack, const std::vector<std::string>& streamIds = {}) const;
 
+        void setDegradationPreference(MediaStreamTrack *mediaStreamTrack, DegradationPreference preference) const;
+
+        void setTemporalLayers(MediaStreamTrack *mediaStreamTrack, uint8_t temporalLayers) const;
+
+        // Bitrates in bps, 0 removes the limit. The minimum goes to the lowest encoding, the maximum caps every one
+        void setBitrateLimits(MediaStreamTrack *mediaStreamTrack, uint32_t minBitrate, uint32_t maxBitrate) const;
+
         void restartIce() const;
 
+        [[nodiscard]] const FactoryConfig& factoryConfig() const;
+
+        [[nodiscard]] const rtc::scoped_refptr<PeerConnectionFactory>& peerConnectionFactory() const;
+
+        [[nodiscard]] const std::shared_ptr<EncoderControl>& encoderControl() const;
+
         void close();
 
         void onIceStateChange(const std::function<void(IceState state)> &callback);
@@ -41,7 +80,10 @@ namespace wrtc {
     private:
         rtc::scoped_refptr<PeerConnectionFactory> factory;
         rtc::scoped_refptr<webrtc::PeerConnectionInterface> peerConnection;
+        std::shared_ptr<EncoderControl> _encoderControl = EncoderControl::Create();
         bool isClosed = false;
+        // Sender parameters are a read-modify-write guarded by a transaction id, concurrent updates would reject each other
+        mutable std::mutex sendersMutex;
 
         synchronized_callback<IceState> stateChangeCallback;
         synchronized_callback<GatheringState> gatheringStateChangeCallback;
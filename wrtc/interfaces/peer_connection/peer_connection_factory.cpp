@@ -3,22 +3,31 @@
 //
 
 #include "peer_connection_factory.hpp"
+
+#include <algorithm>
 #include <api/enable_media.h>
 #include <rtc_base/ssl_adapter.h>
+#include <rtc_base/rtc_certificate_generator.h>
+#include <rtc_base/time_utils.h>
 #include <api/create_peerconnection_factory.h>
 #include <api/rtc_event_log/rtc_event_log_factory.h>
 #include <api/task_queue/default_task_queue_factory.h>
-#include <api/audio_codecs/builtin_audio_encoder_factory.h>
 #include <api/audio_codecs/builtin_audio_decoder_factory.h>
+#include <modules/audio_device/include/fake_audio_device.h>
 #include "peer_connection_factory_with_context.hpp"
+#include "../../audio_factory/audio_encoder_factory.hpp"
 #include "../../video_factory/video_factory_config.hpp"
 
 namespace wrtc {
     std::mutex PeerConnectionFactory::_mutex{};
     int PeerConnectionFactory::_references = 0;
-    rtc::scoped_refptr<PeerConnectionFactory> PeerConnectionFactory::_default = nullptr;
+    std::vector<rtc::scoped_refptr<PeerConnectionFactory>> PeerConnectionFactory::_pool{};
+    FactoryConfig PeerConnectionFactory::_config{};
+    rtc::scoped_refptr<rtc::RTCCertificate> PeerConnectionFactory::_certificate{};
+    std::chrono::steady_clock::time_point PeerConnectionFactory::_certificateTime{};
 
     PeerConnectionFactory::PeerConnectionFactory() {
+        config_ = _config;
         network_thread_ = rtc::Thread::CreateWithSocketServer();
         network_thread_->Start();
         worker_thread_ = rtc::Thread::Create();
@@ -35,17 +44,29 @@ namespace wrtc {
                 absl::make_unique<webrtc::RtcEventLogFactory>(
                         dependencies.task_queue_factory.get());
         dependencies.adm = worker_thread_->BlockingCall([&] {
-            if (!_audioDeviceModule)
-                _audioDeviceModule = webrtc::AudioDeviceModule::Create(webrtc::AudioDeviceModule::kDummyAudio, dependencies.task_queue_factory.get());
+            if (!_audioDeviceModule) {
+                if (config_.audioProfile == AudioProfile::Voice) {
+                    _audioDeviceModule = webrtc::AudioDeviceModule::Create(webrtc::AudioDeviceModule::kDummyAudio, dependencies.task_queue_factory.get());
+                } else {
+                    // Samples go straight to the track sinks, so nothing is ever captured nor played out,
+                    // unlike the dummy device this one has no device buffer nor its timer thread
+                    _audioDeviceModule = rtc::make_ref_counted<webrtc::FakeAudioDeviceModule>();
+                }
+            }
             return _audioDeviceModule;
         });
         auto config = VideoFactoryConfig();
-        dependencies.audio_encoder_factory = webrtc::CreateBuiltinAudioEncoderFactory();
+        dependencies.audio_encoder_factory = CreateAudioEncoderFactory();
         dependencies.audio_decoder_factory = webrtc::CreateBuiltinAudioDecoderFactory();
         dependencies.video_encoder_factory = config.CreateVideoEncoderFactory();
         dependencies.video_decoder_factory = config.CreateVideoDecoderFactory();
         dependencies.audio_mixer = nullptr;
-        dependencies.audio_processing = webrtc::AudioProcessingBuilder().Create();
+        if (config_.audioProfile == AudioProfile::Voice) {
+            dependencies.audio_processing = webrtc::AudioProcessingBuilder().Create();
+        } else {
+            // Pre-mixed sources, no echo cancellation, noise suppression or AGC needed
+            dependencies.audio_processing = nullptr;
+        }
 
         EnableMedia(dependencies);
         if (!factory_) {
@@ -77,25 +98,77 @@ namespace wrtc {
         return factory_;
     }
 
+    const FactoryConfig& PeerConnectionFactory::config() const {
+        return config_;
+    }
+
+    rtc::Thread* PeerConnectionFactory::signalingThread() const {
+        return signaling_thread_.get();
+    }
+
     rtc::scoped_refptr<PeerConnectionFactory> PeerConnectionFactory::GetOrCreateDefault() {
-        _mutex.lock();
+        std::lock_guard lock(_mutex);
         _references++;
         if (_references == 1) {
             rtc::InitializeSSL();
-            _default = rtc::scoped_refptr<PeerConnectionFactory>(new rtc::RefCountedObject<PeerConnectionFactory>());
+            // Each factory brings its own network, worker and signaling threads
+            for (int i = 0; i < std::max<int>(_config.poolSize, 1); i++) {
+                _pool.emplace_back(new rtc::RefCountedObject<PeerConnectionFactory>());
+            }
+            if (_config.certificateRotation) {
+                // Generated ahead, so the first offers skip the key generation too
+                generateCertificate();
+            }
         }
-        _mutex.unlock();
-        return _default;
+        const auto& factory = *std::min_element(_pool.begin(), _pool.end(), [](const auto& a, const auto& b) {
+            return a->load_ < b->load_;
+        });
+        factory->load_++;
+        return factory;
     }
 
-    void PeerConnectionFactory::UnRef() {
-        _mutex.lock();
+    void PeerConnectionFactory::UnRef(const rtc::scoped_refptr<PeerConnectionFactory>& factory) {
+        std::lock_guard lock(_mutex);
+        factory->load_--;
         _references--;
         if (!_references) {
+            _certificate = nullptr;
             rtc::CleanupSSL();
             rtc::ThreadManager::Instance()->SetCurrentThread(nullptr);
-            _default = nullptr;
+            _pool.clear();
+        }
+    }
+
+    bool PeerConnectionFactory::SetConfig(const FactoryConfig& config) {
+        std::lock_guard lock(_mutex);
+        if (_references > 0) {
+            return false;
         }
-        _mutex.unlock();
+        _config = config;
+        return true;
+    }
+
+    FactoryConfig PeerConnectionFactory::GetConfig() {
+        std::lock_guard lock(_mutex);
+        return _config;
+    }
+
+    rtc::scoped_refptr<rtc::RTCCertificate> PeerConnectionFactory::Certificate(const FactoryConfig& config) {
+        if (!config.certificateRotation) {
+            return nullptr;
+        }
+        std::lock_guard lock(_mutex);
+        if (!_certificate ||
+            std::chrono::steady_clock::now() - _certificateTime >= std::chrono::seconds(config.certificateRotation) ||
+            _certificate->HasExpired(rtc::TimeMillis())) {
+            generateCertificate();
+        }
+        return _certificate;
+    }
+
+    void PeerConnectionFactory::generateCertificate() {
+        // Same ECDSA P-256 key WebRTC generates on its own, valid for its default 30 days
+        _certificate = rtc::RTCCertificateGenerator::GenerateCertificate(rtc::KeyParams::ECDSA(rtc::EC_NIST_P256), absl::nullopt);
+        _certificateTime = std::chrono::steady_clock::now();
     }
 } // wrtc
\ No newline at end of file
@@ -4,10 +4,14 @@
 
 #pragma once
 
+#include <chrono>
 #include <mutex>
+#include <vector>
 #include <api/peer_connection_interface.h>
 #include <media/engine/webrtc_media_engine.h>
+#include <rtc_base/rtc_certificate.h>
 #include "pc/connection_context.h"
+#include "../../models/factory_config.hpp"
 
 namespace wrtc {
 
@@ -17,15 +21,37 @@ namespace wrtc {
 
         ~PeerConnectionFactory() override;
 
+        // Least loaded factory of the default pool, the pool is created with the first reference
         static rtc::scoped_refptr<PeerConnectionFactory> GetOrCreateDefault();
 
-        static void UnRef();
+        static void UnRef(const rtc::scoped_refptr<PeerConnectionFactory>& factory);
+
+        // Takes effect the next time the default factory is created, false while the pool is alive
+        static bool SetConfig(const FactoryConfig& config);
+
+        static FactoryConfig GetConfig();
+
+        // Shared by every factory of the pool, nullptr when the config disables the cache
+        static rtc::scoped_refptr<rtc::RTCCertificate> Certificate(const FactoryConfig& config);
 
         rtc::scoped_refptr<webrtc::PeerConnectionFactoryInterface> factory();
+
+        [[nodiscard]] const FactoryConfig& config() const;
+
+        [[nodiscard]] rtc::Thread* signalingThread() const;
     private:
         static std::mutex _mutex;
         static int _references;
-        static rtc::scoped_refptr<PeerConnectionFactory> _default;
+        static std::vector<rtc::scoped_refptr<PeerConnectionFactory>> _pool;
+        static FactoryConfig _config;
+        static rtc::scoped_refptr<rtc::RTCCertificate> _certificate;
+        static std::chrono::steady_clock::time_point _certificateTime;
+
+        static void generateCertificate();
+
+        FactoryConfig config_;
+        // PeerConnections currently created from this factory, guarded by _mutex
+        int load_ = 0;
 
         std::unique_ptr<rtc::Thread> network_thread_;
         std::unique_ptr<rtc::Thread> worker_thread_;
@@ -0,0 +1,33 @@
+//
+// Created by Laky64 on 18/10/2026.
+//
+
+#pragma once
+
+#include <cstdint>
+
+#include "../enums.hpp"
+
+namespace wrtc {
+
+    struct FactoryConfig {
+        AudioProfile audioProfile = AudioProfile::Voice;
+        // Milliseconds to wait for ICE to connect, 0 waits forever
+        uint32_t connectTimeout = 0;
+        // Factories sharing the calls, each with its own network, worker and signaling threads, 0 or 1 for a single one
+        uint8_t poolSize = 1;
+        // Seconds a DTLS certificate is shared by new connections before a new one is generated, 0 generates one per connection
+        uint32_t certificateRotation = 0;
+        // Restricted only gathers UDP host candidates on low cost networks, the only ones Telegram's ice-lite servers can pair with
+        IceProfile iceProfile = IceProfile::Standard;
+        // Local UDP port range, 0 lets the OS pick
+        uint16_t minPort = 0;
+        uint16_t maxPort = 0;
+        bool disableIpv6 = false;
+        // Uplink in bps split evenly across the video of every sending call in the process, 0 to disable
+        uint32_t uplinkBudget = 0;
+        // Offers sendonly transceivers, inbound RTP is dropped before any jitter buffer or decoder is set up
+        bool sendOnly = false;
+    };
+
+} // wrtc
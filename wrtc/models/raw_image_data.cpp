@@ -0,0 +1,106 @@
+//
+// Created by Laky64 on 13/08/2023.
+//
+
+#include "raw_image_data.hpp"
+
+#include <cmath>
+#include <libyuv/convert.h>
+#include <libyuv/planar_functions.h>
+
+namespace wrtc {
+    size_t RawImageData::sizeOfLuminancePlane() const {
+        return static_cast<size_t>(width * height);
+    }
+
+    size_t RawImageData::sizeOfChromaPlane() const {
+        return sizeOfLuminancePlane() / 4;
+    }
+
+    int RawImageData::chromaWidth() const {
+        return width / 2;
+    }
+
+    uint8_t* RawImageData::data() const {
+        return contents.get();
+    }
+
+    RawImageData::RawImageData(const uint16_t width, const uint16_t height, const PixelFormat format, const binary& contents) {
+        this->width = width;
+        this->height = height;
+        this->format = format;
+        this->contents = contents;
+    }
+
+    RawImageData::~RawImageData() {
+        this->contents = nullptr;
+    }
+
+    int64_t RawImageData::frameSize(const PixelFormat format, const uint16_t width, const uint16_t height) {
+        const auto pixels = static_cast<int64_t>(width) * height;
+        switch (format) {
+            case PixelFormat::I420:
+            case PixelFormat::NV12:
+                return llround(static_cast<float>(pixels) * 1.5f);
+            case PixelFormat::RGB24:
+                return pixels * 3;
+            case PixelFormat::RGBA:
+            case PixelFormat::BGRA:
+                return pixels * 4;
+            case PixelFormat::YUYV:
+            case PixelFormat::UYVY:
+                return pixels * 2;
+        }
+        return 0;
+    }
+
+    rtc::scoped_refptr<webrtc::VideoFrameBuffer> RawImageData::buffer(webrtc::VideoFrameBufferPool& pool) const {
+        if (format == PixelFormat::NV12) {
+            auto buffer = pool.CreateNV12Buffer(width, height);
+            if (!buffer) {
+                return nullptr;
+            }
+            libyuv::CopyPlane(data(), width, buffer->MutableDataY(), buffer->StrideY(), width, height);
+            libyuv::CopyPlane(data() + sizeOfLuminancePlane(), chromaWidth() * 2, buffer->MutableDataUV(), buffer->StrideUV(), chromaWidth() * 2, height / 2);
+            return buffer;
+        }
+
+        auto buffer = pool.CreateI420Buffer(width, height);
+        if (!buffer) {
+            return nullptr;
+        }
+        const auto dst = buffer.get();
+        switch (format) {
+            case PixelFormat::I420:
+                libyuv::I420Copy(
+                    data(), width,
+                    data() + sizeOfLuminancePlane(), chromaWidth(),
+                    data() + sizeOfLuminancePlane() + sizeOfChromaPlane(), chromaWidth(),
+                    dst->MutableDataY(), dst->StrideY(),
+                    dst->MutableDataU(), dst->StrideU(),
+                    dst->MutableDataV(), dst->StrideV(),
+                    width, height
+                );
+                break;
+            // libyuv names packed RGB formats after their little-endian word order
+            case PixelFormat::RGB24:
+                libyuv::RAWToI420(data(), width * 3, dst->MutableDataY(), dst->StrideY(), dst->MutableDataU(), dst->StrideU(), dst->MutableDataV(), dst->StrideV(), width, height);
+                break;
+            case PixelFormat::RGBA:
+                libyuv::ABGRToI420(data(), width * 4, dst->MutableDataY(), dst->StrideY(), dst->MutableDataU(), dst->StrideU(), dst->MutableDataV(), dst->StrideV(), width, height);
+                break;
+            case PixelFormat::BGRA:
+                libyuv::ARGBToI420(data(), width * 4, dst->MutableDataY(), dst->StrideY(), dst->MutableDataU(), dst->StrideU(), dst->MutableDataV(), dst->StrideV(), width, height);
+                break;
+            case PixelFormat::YUYV:
+                libyuv::YUY2ToI420(data(), width * 2, dst->MutableDataY(), dst->StrideY(), dst->MutableDataU(), dst->StrideU(), dst->MutableDataV(), dst->StrideV(), width, height);
+                break;
+            case PixelFormat::UYVY:
+                libyuv::UYVYToI420(data(), width * 2, dst->MutableDataY(), dst->StrideY(), dst->MutableDataU(), dst->StrideU(), dst->MutableDataV(), dst->StrideV(), width, height);
+                break;
+            case PixelFormat::NV12:
+                break;
+        }
+        return buffer;
+    }
+}
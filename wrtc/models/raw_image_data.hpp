@@ -0,0 +1,38 @@
+//
+// Created by Laky64 on 13/08/2023.
+//
+
+#pragma once
+
+
+#include <api/scoped_refptr.h>
+#include <api/video/video_frame_buffer.h>
+#include <common_video/include/video_frame_buffer_pool.h>
+
+#include "rtc_on_data_event.hpp"
+
+namespace wrtc {
+    class RawImageData {
+        uint16_t width, height;
+        PixelFormat format;
+        binary contents;
+
+        [[nodiscard]] size_t sizeOfLuminancePlane() const;
+
+        [[nodiscard]] size_t sizeOfChromaPlane() const;
+
+        [[nodiscard]] int chromaWidth() const;
+
+        [[nodiscard]] uint8_t* data() const;
+
+    public:
+        RawImageData(uint16_t width, uint16_t height, PixelFormat format, const binary& contents);
+
+        ~RawImageData();
+
+        [[nodiscard]] static int64_t frameSize(PixelFormat format, uint16_t width, uint16_t height);
+
+        // I420 and NV12 are copied as they are, any other format is converted to I420
+        [[nodiscard]] rtc::scoped_refptr<webrtc::VideoFrameBuffer> buffer(webrtc::VideoFrameBufferPool& pool) const;
+    };
+}
@@ -4,6 +4,7 @@
 
 #pragma once
 
+#include <chrono>
 #include <cstdint>
 #include "../enums.hpp"
 
@@ -20,6 +21,8 @@ namespace wrtc {
     uint32_t sampleRate = 48000;
     uint8_t bitsPerSample = 16;
     uint8_t channelCount = 1;
+    // Capture time on the media clock, zero stamps the data when it is pushed
+    std::chrono::microseconds timestamp = std::chrono::microseconds::zero();
   };
 
 } // namespace wrtc
@@ -4,6 +4,7 @@
 
 #include "sdp_builder.hpp"
 
+#include <algorithm>
 #include <sstream>
 #include <rtc_base/helpers.h>
 
@@ -76,7 +77,102 @@ namespace wrtc {
         }
     }
 
-    void SdpBuilder::addSsrcEntry(const Transport& transport) {
+    void SdpBuilder::addOpusParams(const OpusParams& opus) {
+        push("a=fmtp:111 minptime=10");
+        push("; ptime=" + std::to_string(opus.packetTime));
+        push("; useinbandfec=" + std::string(opus.fec ? "1" : "0"));
+        push("; usedtx=1");
+        if (opus.stereo) {
+            push("; stereo=1; sprop-stereo=1");
+        }
+        if (opus.maxBitrate) {
+            push("; maxaveragebitrate=" + std::to_string(opus.maxBitrate));
+        }
+        if (opus.complexity >= 0) {
+            // Not part of RFC 7587, only read by our own encoder factory
+            push("; x-ntg-complexity=" + std::to_string(opus.complexity));
+        }
+        addJoined();
+    }
+
+    void SdpBuilder::addVideoParams(const int payloadType, const VideoParams& video, const std::string& baseParams) {
+        std::vector<std::string> params;
+        if (!baseParams.empty()) {
+            params.push_back(baseParams);
+        }
+        // Not part of any payload format, only read by our own encoder factory
+        if (video.threads) {
+            params.push_back("x-ntg-threads=" + std::to_string(video.threads));
+        }
+        if (video.preset != EncoderPreset::Default) {
+            params.push_back("x-ntg-preset=" + std::to_string(static_cast<int>(video.preset)));
+        }
+        if (!video.controlId.empty()) {
+            params.push_back("x-ntg-control=" + video.controlId);
+        }
+        if (params.empty()) {
+            return;
+        }
+        push("a=fmtp:" + std::to_string(payloadType) + " ");
+        for (size_t i = 0; i < params.size(); ++i) {
+            push(i ? "; " + params[i] : params[i]);
+        }
+        addJoined();
+    }
+
+    std::pair<int, int> SdpBuilder::videoPayloadTypes(const VideoCodec codec, const VideoParams& video) {
+        if (const auto it = video.payloadTypes.find(codec); it != video.payloadTypes.end()) {
+            return it->second;
+        }
+        // Each codec is followed by its RTX payload type
+        switch (codec) {
+            case VideoCodec::VP8:
+                return {100, 101};
+            case VideoCodec::VP9:
+                return {102, 103};
+            case VideoCodec::AV1:
+                return {104, 105};
+        }
+        return {0, 0};
+    }
+
+    void SdpBuilder::addVideoCodec(const VideoCodec codec, const VideoParams& video) {
+        const auto [id, rtxId] = videoPayloadTypes(codec, video);
+        const auto payloadType = std::to_string(id);
+        const auto rtxPayloadType = std::to_string(rtxId);
+        switch (codec) {
+            case VideoCodec::VP8:
+                add("a=rtpmap:" + payloadType + " VP8/90000/1");
+                break;
+            case VideoCodec::VP9:
+                add("a=rtpmap:" + payloadType + " VP9/90000/1");
+                break;
+            case VideoCodec::AV1:
+                add("a=rtpmap:" + payloadType + " AV1/90000");
+                break;
+        }
+        std::string bitrateParams = "x-google-start-bitrate=" + std::to_string(video.startBitrate);
+        if (video.minBitrate) {
+            bitrateParams += "; x-google-min-bitrate=" + std::to_string(video.minBitrate);
+        }
+        if (video.maxBitrate) {
+            bitrateParams += "; x-google-max-bitrate=" + std::to_string(video.maxBitrate);
+        }
+        addVideoParams(id, video, bitrateParams);
+        add("a=rtcp-fb:" + payloadType + " goog-remb");
+        add("a=rtcp-fb:" + payloadType + " transport-cc");
+        add("a=rtcp-fb:" + payloadType + " ccm fir");
+        add("a=rtcp-fb:" + payloadType + " nack");
+        add("a=rtcp-fb:" + payloadType + " nack pli");
+        if (rtxId) {
+            add("a=rtpmap:" + rtxPayloadType + " rtx/90000");
+            add("a=fmtp:" + rtxPayloadType + " apt=" + payloadType);
+        }
+    }
+
+    void SdpBuilder::addSsrcEntry(const Conference& conference) {
+        const auto& transport = conference.transport;
+
         //AUDIO CODECS
         add("m=audio 1 RTP/SAVPF 111 126");
         add("c=IN IP4 0.0.0.0");
@@ -87,7 +183,7 @@ namespace wrtc {
         // OPUS CODEC
         add("a=rtpmap:111 opus/48000/2");
         add("a=rtpmap:126 telephone-event/8000");
-        add("a=fmtp:111 minptime=10; useinbandfec=1; usedtx=1");
+        addOpusParams(conference.opus);
         add("a=rtcp:1 IN IP4 0.0.0.0");
         add("a=rtcp-mux");
         add("a=rtcp-fb:111 transport-cc");
@@ -96,31 +192,22 @@ namespace wrtc {
         //END AUDIO CODECS
 
         //VIDEO CODECS
-        add("m=video 1 RTP/SAVPF 100 101 102 103");
+        push("m=video 1 RTP/SAVPF");
+        for (const auto codec : conference.video.codecs) {
+            const auto [id, rtxId] = videoPayloadTypes(codec, conference.video);
+            push(" " + std::to_string(id));
+            if (rtxId) {
+                push(" " + std::to_string(rtxId));
+            }
+        }
+        addJoined();
         add("c=IN IP4 0.0.0.0");
         add("a=mid:1");
         addTransport(transport);
 
-        //VP8 CODEC
-        add("a=rtpmap:100 VP8/90000/1");
-        add("a=fmtp:100 x-google-start-bitrate=800");
-        add("a=rtcp-fb:100 goog-remb");
-        add("a=rtcp-fb:100 transport-cc");
-        add("a=rtcp-fb:100 ccm fir");
-        add("a=rtcp-fb:100 nack");
-        add("a=rtcp-fb:100 nack pli");
-        add("a=rtpmap:101 rtx/90000");
-        add("a=fmtp:101 apt=100");
-
-        //VP9 CODEC
-        add("a=rtpmap:102 VP9/90000/1");
-        add("a=rtcp-fb:102 goog-remb");
-        add("a=rtcp-fb:102 transport-cc");
-        add("a=rtcp-fb:102 ccm fir");
-        add("a=rtcp-fb:102 nack");
-        add("a=rtcp-fb:102 nack pli");
-        add("a=rtpmap:103 rtx/90000");
-        add("a=fmtp:103 apt=102");
+        for (const auto codec : conference.video.codecs) {
+            addVideoCodec(codec, conference.video);
+        }
 
         add("a=recvonly");
         add("a=rtcp:1 IN IP4 0.0.0.0");
@@ -130,7 +217,7 @@ namespace wrtc {
 
     void SdpBuilder::addConference(const Conference& conference) {
         addHeader();
-        addSsrcEntry(conference.transport);
+        addSsrcEntry(conference);
     }
 
     std::string SdpBuilder::fromConference(const Conference& conference) {
@@ -139,7 +226,7 @@ namespace wrtc {
         return sdp.finalize();
     }
 
-    Sdp SdpBuilder::parseSdp(const std::string& sdp) {
+    std::vector<std::string> SdpBuilder::splitLines(const std::string& sdp) {
         std::vector<std::string> lines;
         std::string line;
         std::istringstream stream(sdp);
@@ -149,6 +236,11 @@ namespace wrtc {
             }
             lines.push_back(line);
         }
+        return lines;
+    }
+
+    Sdp SdpBuilder::parseSdp(const std::string& sdp) {
+        const auto lines = splitLines(sdp);
 
         auto lookup = [&lines](const std::string& prefix) -> std::string {
             for (const auto& basic_string : lines) {
@@ -160,21 +252,26 @@ namespace wrtc {
         };
 
         std::string rawAudioSource = lookup("a=ssrc:");
-        std::string rawVideoSource = lookup("a=ssrc-group:FID ");
         SSRC audioSource = 0;
-        std::vector<SSRC> sourceGroups;
+        std::vector<SsrcGroup> ssrcGroups;
 
         if (!rawAudioSource.empty()) {
             audioSource = static_cast<SSRC>(std::stoul(rawAudioSource.substr(0, rawAudioSource.find(' '))));
         }
 
-        if (!rawVideoSource.empty()) {
-            size_t pos;
-            while ((pos = rawVideoSource.find(' ')) != std::string::npos) {
-                sourceGroups.push_back(static_cast<SSRC>(std::stoul(rawVideoSource.substr(0, pos))));
-                rawVideoSource.erase(0, pos + 1);
+        const std::string groupPrefix = "a=ssrc-group:";
+        for (const auto& groupLine : lines) {
+            if (groupLine.compare(0, groupPrefix.size(), groupPrefix) != 0) {
+                continue;
             }
-            sourceGroups.push_back(static_cast<SSRC>(std::stoul(rawVideoSource)));
+            std::istringstream words(groupLine.substr(groupPrefix.size()));
+            SsrcGroup group;
+            words >> group.semantics;
+            SSRC ssrc;
+            while (words >> ssrc) {
+                group.ssrcs.push_back(ssrc);
+            }
+            ssrcGroups.push_back(group);
         }
 
         return {
@@ -184,7 +281,105 @@ namespace wrtc {
                 lookup("a=ice-pwd:"),
                 lookup("a=ice-ufrag:"),
                 audioSource,
-                sourceGroups
+                ssrcGroups
         };
     }
-}
+
+    std::string SdpBuilder::addSimulcast(const std::string& sdp, const uint8_t layers) {
+        std::vector<std::pair<SSRC, SSRC>> extraLayers;
+        for (uint8_t i = 1; i < layers; i++) {
+            extraLayers.emplace_back(rtc::CreateRandomNonZeroId(), rtc::CreateRandomNonZeroId());
+        }
+        return addSimulcast(sdp, extraLayers);
+    }
+
+    std::string SdpBuilder::addSimulcast(const std::string& sdp, const std::vector<SsrcGroup>& groups) {
+        std::vector<std::pair<SSRC, SSRC>> extraLayers;
+        for (const auto& [semantics, ssrcs] : groups) {
+            if (semantics != "SIM") {
+                continue;
+            }
+            for (size_t i = 1; i < ssrcs.size(); i++) {
+                SSRC layerRtx = 0;
+                for (const auto& group : groups) {
+                    if (group.semantics == "FID" && group.ssrcs.size() == 2 && group.ssrcs[0] == ssrcs[i]) {
+                        layerRtx = group.ssrcs[1];
+                    }
+                }
+                extraLayers.emplace_back(ssrcs[i], layerRtx);
+            }
+        }
+        return addSimulcast(sdp, extraLayers);
+    }
+
+    std::string SdpBuilder::addSimulcast(const std::string& sdp, const std::vector<std::pair<SSRC, SSRC>>& extraLayers) {
+        // Legacy simulcast: the SIM group lists one primary SSRC per layer, lowest resolution first,
+        // each one with its own FID group for RTX. WebRTC still honors it when munged into the local offer.
+        auto lines = splitLines(sdp);
+        const auto videoStart = std::find_if(lines.begin(), lines.end(), [](const std::string& l) {
+            return l.compare(0, 8, "m=video ") == 0;
+        });
+        if (extraLayers.empty() || videoStart == lines.end()) {
+            return sdp;
+        }
+        const auto videoEnd = std::find_if(videoStart + 1, lines.end(), [](const std::string& l) {
+            return l.compare(0, 2, "m=") == 0;
+        });
+        // Offers created after a renegotiation may already carry the layers, a second SIM group would break them
+        if (std::any_of(videoStart, videoEnd, [](const std::string& l) {
+            return l.compare(0, 17, "a=ssrc-group:SIM ") == 0;
+        })) {
+            return sdp;
+        }
+
+        SSRC primary = 0, rtx = 0;
+        for (auto it = videoStart; it != videoEnd; ++it) {
+            if (it->compare(0, 17, "a=ssrc-group:FID ") == 0) {
+                std::istringstream words(it->substr(17));
+                words >> primary >> rtx;
+                break;
+            }
+        }
+        if (!primary) {
+            return sdp;
+        }
+
+        std::vector<std::string> primaryAttributes, rtxAttributes;
+        const auto primaryPrefix = "a=ssrc:" + std::to_string(primary) + " ";
+        const auto rtxPrefix = "a=ssrc:" + std::to_string(rtx) + " ";
+        for (auto it = videoStart; it != videoEnd; ++it) {
+            if (it->compare(0, primaryPrefix.size(), primaryPrefix) == 0) {
+                primaryAttributes.push_back(it->substr(primaryPrefix.size()));
+            } else if (rtx && it->compare(0, rtxPrefix.size(), rtxPrefix) == 0) {
+                rtxAttributes.push_back(it->substr(rtxPrefix.size()));
+            }
+        }
+
+        std::vector<std::string> extraLines;
+        std::string simGroup = "a=ssrc-group:SIM " + std::to_string(primary);
+        for (const auto& [layerPrimary, layerRetransmission] : extraLayers) {
+            const auto layerSsrc = std::to_string(layerPrimary);
+            const auto layerRtx = std::to_string(layerRetransmission);
+            for (const auto& attribute : primaryAttributes) {
+                extraLines.push_back("a=ssrc:" + layerSsrc + " " + attribute);
+            }
+            if (rtx && layerRetransmission) {
+                for (const auto& attribute : rtxAttributes) {
+                    extraLines.push_back("a=ssrc:" + layerRtx + " " + attribute);
+                }
+                extraLines.push_back("a=ssrc-group:FID " + layerSsrc + " " + layerRtx);
+            }
+            simGroup += " " + layerSsrc;
+        }
+        extraLines.push_back(simGroup);
+        lines.insert(videoEnd, extraLines.begin(), extraLines.end());
+
+        std::string munged;
+        for (const auto& line : lines) {
+            if (!line.empty()) {
+                munged += line + "\r\n";
+            }
+        }
+        return munged;
+    }
+}
\ No newline at end of file
@@ -4,8 +4,10 @@
 
 #pragma once
 
+#include <map>
 #include <vector>
 #include <string>
+#include <utility>
 
 #include "enums.hpp"
 
@@ -36,10 +38,40 @@ namespace wrtc {
         std::vector<Candidate> candidates;
     };
 
+    struct SsrcGroup {
+        std::string semantics;
+        std::vector<SSRC> ssrcs;
+    };
+
+    struct OpusParams {
+        bool stereo = false;
+        uint32_t maxBitrate = 0;
+        int8_t complexity = -1;
+        bool fec = true;
+        uint8_t packetTime = 10;
+    };
+
+    struct VideoParams {
+        // Offered in this order, the first one supported by both sides is used to send
+        std::vector<VideoCodec> codecs = {VideoCodec::VP8, VideoCodec::VP9};
+        uint8_t threads = 0;
+        EncoderPreset preset = EncoderPreset::Default;
+        // Id of the EncoderControl the encoders of this call attach to
+        std::string controlId;
+        // Bandwidth estimation bounds in kbps, 0 leaves min and max to WebRTC
+        uint32_t startBitrate = 800;
+        uint32_t minBitrate = 0;
+        uint32_t maxBitrate = 0;
+        // Payload type and RTX payload type (0 for none) announced by the server, missing codecs use our defaults
+        std::map<VideoCodec, std::pair<int, int>> payloadTypes;
+    };
+
     struct Conference {
         Transport transport;
         SSRC ssrc;
         std::vector<SSRC> source_groups;
+        OpusParams opus;
+        VideoParams video;
     };
 
     struct Sdp {
@@ -49,10 +81,15 @@ namespace wrtc {
         std::string pwd;
         std::string ufrag;
         SSRC audioSource;
-        std::vector<SSRC> source_groups;
+        std::vector<SsrcGroup> ssrcGroups;
     };
 
     class SdpBuilder {
+        static std::vector<std::string> splitLines(const std::string& sdp);
+
+        // Each extra layer is its primary SSRC and its RTX SSRC
+        static std::string addSimulcast(const std::string& sdp, const std::vector<std::pair<SSRC, SSRC>>& extraLayers);
+
         std::vector<std::string> lines;
         std::vector<std::string> newLine;
 
@@ -62,7 +99,12 @@ namespace wrtc {
         void addCandidate(const Candidate& c);
         void addHeader();
         void addTransport(const Transport& transport);
-        void addSsrcEntry(const Transport& transport);
+        void addOpusParams(const OpusParams& opus);
+        void addVideoParams(int payloadType, const VideoParams& video, const std::string& baseParams = "");
+        void addVideoCodec(VideoCodec codec, const VideoParams& video);
+        void addSsrcEntry(const Conference& conference);
+
+        static std::pair<int, int> videoPayloadTypes(VideoCodec codec, const VideoParams& video);
 
         [[nodiscard]] std::string join() const;
         [[nodiscard]] std::string finalize() const;
@@ -72,5 +114,10 @@ namespace wrtc {
         static std::string fromConference(const Conference& conference);
 
         static Sdp parseSdp(const std::string& sdp);
+
+        static std::string addSimulcast(const std::string& sdp, uint8_t layers);
+
+        // Same layers as the groups of a previous offer, so a renegotiation keeps the SSRCs the server knows
+        static std::string addSimulcast(const std::string& sdp, const std::vector<SsrcGroup>& groups);
     };
 }
\ No newline at end of file
@@ -0,0 +1,17 @@
+//
+// Created by Laky64 on 18/10/2026.
+//
+
+#pragma once
+
+#include <chrono>
+#include <rtc_base/time_utils.h>
+
+namespace wrtc {
+
+    // Monotonic clock used by WebRTC to stamp captured media, capture timestamps must be taken from it
+    inline std::chrono::microseconds mediaClock() {
+        return std::chrono::microseconds(rtc::TimeMicros());
+    }
+
+} // wrtc
@@ -0,0 +1,54 @@
+//
+// Created by Laky64 on 18/10/2026.
+//
+
+#include "encoder_control.hpp"
+
+#include <rtc_base/helpers.h>
+
+namespace wrtc {
+    std::mutex EncoderControl::_mutex{};
+    std::map<std::string, std::weak_ptr<EncoderControl>> EncoderControl::_controls{};
+
+    EncoderControl::EncoderControl(std::string id): _id(std::move(id)) {}
+
+    EncoderControl::~EncoderControl() {
+        std::lock_guard lock(_mutex);
+        _controls.erase(_id);
+    }
+
+    std::shared_ptr<EncoderControl> EncoderControl::Create() {
+        auto control = std::make_shared<EncoderControl>(rtc::CreateRandomUuid());
+        std::lock_guard lock(_mutex);
+        _controls[control->id()] = control;
+        return control;
+    }
+
+    std::shared_ptr<EncoderControl> EncoderControl::Find(const std::string& id) {
+        std::lock_guard lock(_mutex);
+        if (const auto it = _controls.find(id); it != _controls.end()) {
+            return it->second.lock();
+        }
+        return nullptr;
+    }
+
+    const std::string& EncoderControl::id() const {
+        return _id;
+    }
+
+    void EncoderControl::requestKeyframe() {
+        ++_keyframeRequests;
+    }
+
+    uint64_t EncoderControl::keyframeRequests() const {
+        return _keyframeRequests;
+    }
+
+    void EncoderControl::setKeyframeInterval(const std::chrono::milliseconds interval) {
+        _keyframeInterval = interval.count();
+    }
+
+    std::chrono::milliseconds EncoderControl::keyframeInterval() const {
+        return std::chrono::milliseconds(_keyframeInterval.load());
+    }
+} // wrtc
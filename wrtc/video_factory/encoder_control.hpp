@@ -0,0 +1,47 @@
+//
+// Created by Laky64 on 18/10/2026.
+//
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+
+namespace wrtc {
+
+    // Shared between a PeerConnection and the encoders negotiated for it, which find it through x-ntg-control
+    class EncoderControl {
+    public:
+        explicit EncoderControl(std::string id);
+
+        ~EncoderControl();
+
+        static std::shared_ptr<EncoderControl> Create();
+
+        static std::shared_ptr<EncoderControl> Find(const std::string& id);
+
+        [[nodiscard]] const std::string& id() const;
+
+        void requestKeyframe();
+
+        [[nodiscard]] uint64_t keyframeRequests() const;
+
+        // Zero leaves keyframes to the encoder and to receiver requests
+        void setKeyframeInterval(std::chrono::milliseconds interval);
+
+        [[nodiscard]] std::chrono::milliseconds keyframeInterval() const;
+
+    private:
+        static std::mutex _mutex;
+        static std::map<std::string, std::weak_ptr<EncoderControl>> _controls;
+
+        std::string _id;
+        std::atomic<uint64_t> _keyframeRequests = 0;
+        std::atomic<int64_t> _keyframeInterval = 0;
+    };
+
+} // wrtc
@@ -0,0 +1,133 @@
+//
+// Created by Laky64 on 18/10/2026.
+//
+
+#include "profiled_video_encoder.hpp"
+
+#include <algorithm>
+#include <rtc_base/string_to_number.h>
+
+#include "../enums.hpp"
+
+namespace wrtc {
+
+    ProfiledVideoEncoder::ProfiledVideoEncoder(
+        std::unique_ptr<VideoEncoder> encoder,
+        const int threads,
+        const absl::optional<webrtc::VideoCodecComplexity> complexity,
+        std::shared_ptr<EncoderControl> control
+    ): encoder(std::move(encoder)), threads(threads), complexity(complexity), control(std::move(control)) {
+        if (this->control) {
+            // Requests made before this encoder existed are already covered by its first keyframe
+            handledKeyframeRequests = this->control->keyframeRequests();
+        }
+    }
+
+    std::unique_ptr<webrtc::VideoEncoder> ProfiledVideoEncoder::Wrap(std::unique_ptr<VideoEncoder> encoder, const webrtc::SdpVideoFormat& format) {
+        if (!encoder) {
+            return encoder;
+        }
+        int threads = 0;
+        absl::optional<webrtc::VideoCodecComplexity> complexity;
+        if (const auto it = format.parameters.find("x-ntg-threads"); it != format.parameters.end()) {
+            if (const auto value = rtc::StringToNumber<int>(it->second); value && *value > 0) {
+                threads = *value;
+            }
+        }
+        if (const auto it = format.parameters.find("x-ntg-preset"); it != format.parameters.end()) {
+            // libvpx and libaom only move cpu-used away from their realtime default for high complexity and above,
+            // so the codec complexity can slow the encoders down but never speed them up
+            switch (static_cast<EncoderPreset>(rtc::StringToNumber<int>(it->second).value_or(0))) {
+                case EncoderPreset::Quality:
+                    complexity = webrtc::VideoCodecComplexity::kComplexityHigh;
+                    break;
+                default:
+                    break;
+            }
+        }
+        std::shared_ptr<EncoderControl> control;
+        if (const auto it = format.parameters.find("x-ntg-control"); it != format.parameters.end()) {
+            control = EncoderControl::Find(it->second);
+        }
+        if (!threads && !complexity && !control) {
+            return encoder;
+        }
+        return std::make_unique<ProfiledVideoEncoder>(std::move(encoder), threads, complexity, std::move(control));
+    }
+
+    void ProfiledVideoEncoder::SetFecControllerOverride(webrtc::FecControllerOverride* fecControllerOverride) {
+        encoder->SetFecControllerOverride(fecControllerOverride);
+    }
+
+    int ProfiledVideoEncoder::InitEncode(const webrtc::VideoCodec* codecSettings, const Settings& settings) {
+        webrtc::VideoCodec codec = *codecSettings;
+        if (complexity) {
+            codec.SetVideoEncoderComplexity(*complexity);
+        }
+        // Encoders size their thread pool from the core count, so this caps the threads used by one call
+        Settings profiledSettings(settings.capabilities, threads ? threads : settings.number_of_cores, settings.max_payload_size);
+        return encoder->InitEncode(&codec, profiledSettings);
+    }
+
+    int32_t ProfiledVideoEncoder::RegisterEncodeCompleteCallback(webrtc::EncodedImageCallback* callback) {
+        return encoder->RegisterEncodeCompleteCallback(callback);
+    }
+
+    int32_t ProfiledVideoEncoder::Release() {
+        return encoder->Release();
+    }
+
+    bool ProfiledVideoEncoder::needsKeyframe(const webrtc::VideoFrame& frame, const std::vector<webrtc::VideoFrameType>* frameTypes) {
+        const auto timestamp = frame.timestamp_us();
+        if (frameTypes && std::find(frameTypes->begin(), frameTypes->end(), webrtc::VideoFrameType::kVideoFrameKey) != frameTypes->end()) {
+            lastKeyframeUs = timestamp;
+            return false;
+        }
+        if (lastKeyframeUs < 0) {
+            // The first frame is always encoded as a keyframe
+            lastKeyframeUs = timestamp;
+        }
+        bool needed = false;
+        if (const auto requests = control->keyframeRequests(); requests != handledKeyframeRequests) {
+            handledKeyframeRequests = requests;
+            needed = true;
+        }
+        if (const auto interval = control->keyframeInterval(); interval.count() && timestamp - lastKeyframeUs >= std::chrono::microseconds(interval).count()) {
+            needed = true;
+        }
+        if (needed) {
+            lastKeyframeUs = timestamp;
+        }
+        return needed;
+    }
+
+    int32_t ProfiledVideoEncoder::Encode(const webrtc::VideoFrame& frame, const std::vector<webrtc::VideoFrameType>* frameTypes) {
+        if (control && needsKeyframe(frame, frameTypes)) {
+            // One entry per simulcast stream handled by this encoder
+            const std::vector keyframeTypes(frameTypes ? frameTypes->size() : 1, webrtc::VideoFrameType::kVideoFrameKey);
+            return encoder->Encode(frame, &keyframeTypes);
+        }
+        return encoder->Encode(frame, frameTypes);
+    }
+
+    void ProfiledVideoEncoder::SetRates(const RateControlParameters& parameters) {
+        encoder->SetRates(parameters);
+    }
+
+    void ProfiledVideoEncoder::OnPacketLossRateUpdate(const float packetLossRate) {
+        encoder->OnPacketLossRateUpdate(packetLossRate);
+    }
+
+    void ProfiledVideoEncoder::OnRttUpdate(const int64_t rttMs) {
+        encoder->OnRttUpdate(rttMs);
+    }
+
+    void ProfiledVideoEncoder::OnLossNotification(const LossNotification& lossNotification) {
+        encoder->OnLossNotification(lossNotification);
+    }
+
+    webrtc::VideoEncoder::EncoderInfo ProfiledVideoEncoder::GetEncoderInfo() const {
+        return encoder->GetEncoderInfo();
+    }
+
+} // wrtc
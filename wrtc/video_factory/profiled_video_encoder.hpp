@@ -0,0 +1,56 @@
+//
+// Created by Laky64 on 18/10/2026.
+//
+
+#pragma once
+
+#include <api/video_codecs/video_encoder.h>
+#include <api/video_codecs/sdp_video_format.h>
+
+#include "encoder_control.hpp"
+
+namespace wrtc {
+
+    // Applies the per-call x-ntg-threads, x-ntg-preset and x-ntg-control format parameters to any software encoder
+    class ProfiledVideoEncoder final : public webrtc::VideoEncoder {
+        std::unique_ptr<VideoEncoder> encoder;
+        int threads = 0;
+        absl::optional<webrtc::VideoCodecComplexity> complexity;
+        std::shared_ptr<EncoderControl> control;
+        uint64_t handledKeyframeRequests = 0;
+        int64_t lastKeyframeUs = -1;
+
+        bool needsKeyframe(const webrtc::VideoFrame& frame, const std::vector<webrtc::VideoFrameType>* frameTypes);
+
+    public:
+        ProfiledVideoEncoder(
+            std::unique_ptr<VideoEncoder> encoder,
+            int threads,
+            absl::optional<webrtc::VideoCodecComplexity> complexity,
+            std::shared_ptr<EncoderControl> control
+        );
+
+        static std::unique_ptr<VideoEncoder> Wrap(std::unique_ptr<VideoEncoder> encoder, const webrtc::SdpVideoFormat& format);
+
+        void SetFecControllerOverride(webrtc::FecControllerOverride* fecControllerOverride) override;
+
+        int InitEncode(const webrtc::VideoCodec* codecSettings, const Settings& settings) override;
+
+        int32_t RegisterEncodeCompleteCallback(webrtc::EncodedImageCallback* callback) override;
+
+        int32_t Release() override;
+
+        int32_t Encode(const webrtc::VideoFrame& frame, const std::vector<webrtc::VideoFrameType>* frameTypes) override;
+
+        void SetRates(const RateControlParameters& parameters) override;
+
+        void OnPacketLossRateUpdate(float packetLossRate) override;
+
+        void OnRttUpdate(int64_t rttMs) override;
+
+        void OnLossNotification(const LossNotification& lossNotification) override;
+
+        EncoderInfo GetEncoderInfo() const override;
+    };
+
+} // wrtc
@@ -4,6 +4,7 @@
 
 #include "google.hpp"
 
+#include <media/base/codec.h>
 #include <modules/video_coding/codecs/vp8/include/vp8.h>
 #include <modules/video_coding/codecs/vp9/include/vp9.h>
 
@@ -18,8 +19,8 @@ namespace google {
         );
         encoders.emplace_back(
             webrtc::kVideoCodecVP9,
-            [](auto) {
-                return webrtc::VP8Encoder::Create();
+            [](const webrtc::SdpVideoFormat& format) {
+                return webrtc::VP9Encoder::Create(cricket::CreateVideoCodec(format));
             }
         );
     }
@@ -8,5 +8,6 @@
 #include "enums.hpp"
 #include "interfaces/peer_connection.hpp"
 #include "sdp_builder.hpp"
+#include "utils/media_clock.hpp"
 #include "wrtc/interfaces/media/rtc_audio_source.hpp"
 #include "wrtc/interfaces/media/rtc_video_source.hpp"
\ No newline at end of file